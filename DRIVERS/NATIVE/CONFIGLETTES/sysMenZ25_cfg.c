@@ -29,6 +29,7 @@
 #include "drv/pci/pciIntLib.h"
 
 #include "intLib.h"
+#include "taskLib.h"
 #include "miiLib.h"
 #include "end.h"
 
@@ -46,6 +47,12 @@
     #endif
 #endif
 
+#ifdef Z025_PROFILE_DRIVER
+    #ifndef Z25_PROFILE
+        #define Z25_PROFILE
+    #endif
+#endif
+
 #include <MEN/men_typs.h>
 #include <MEN/oss.h>
 #include <MEN/dbg.h>
@@ -57,6 +64,36 @@
 #include <DRIVERS/NATIVE/Z25_UART/z25_driver.c>
 #include <DRIVERS/NATIVE/Z25_UART/mz25_module.c>
 
+#ifdef MEN_Z025_STATIC_MAP
+/*
+ * Static device map, no PCI bus scan at boot. Example (config.h):
+ *
+ * #define MEN_Z025_STATIC_UNITS \
+ *     { { CHAMELEON_16Z125_UART, 0, 0x1100, 1 }, \
+ *       { CHAMELEON_16Z125_UART, 0, 0x1200, 1 } }
+ * #define MEN_Z025_STATIC_MAP \
+ *     { { 0, 3, 0, 0, &sysZ25StaticUnits[0], 2 }, \
+ *       { 0, 5, 0, 0, NULL, 0 } }
+ *
+ * The first FPGA is installed with the given units, the units of the
+ * second one are read from its Chameleon table. The units of all map
+ * entries are numbered in map order and all of them are installed by
+ * sysZ25Init below. MEN_Z025_STATIC_VERIFY compares the map with the
+ * Chameleon tables of the hardware after boot.
+ */
+#ifdef MEN_Z025_STATIC_UNITS
+LOCAL const Z25_STATIC_UNIT sysZ25StaticUnits[] = MEN_Z025_STATIC_UNITS;
+#endif
+LOCAL const Z25_STATIC_DEV sysZ25StaticMap[] = MEN_Z025_STATIC_MAP;
+
+#ifndef MEN_Z025_STATIC_VERIFY
+#define MEN_Z025_STATIC_VERIFY      TRUE
+#endif
+#ifndef MEN_Z025_STATIC_VERIFY_PRIO
+#define MEN_Z025_STATIC_VERIFY_PRIO 250
+#endif
+#endif /* MEN_Z025_STATIC_MAP */
+
 /******************************************************************************
  *     Initialize the serial devices, can be included like this in any BSP
  *
@@ -67,13 +104,25 @@ STATUS sysZ25Init(void)
       u_int16 j, k;
       u_int16 unit = 0;
       u_int16 maxUnit = 0;
+      u_int16 firstUnit = 0xffff;
+      u_int16 endUnit = 0;
       Z25_DEV_TS *z25DevP;
       u_int16 loopIndex = 0;
-      int8 l_const = -1;
+      int16 l_const = -1;
       u_int32 frequency = 0;
 
+#ifdef MEN_Z025_PCI_DOMAIN_MASK
+      /* scan all given PCI domains, bit n = domain n */
+      G_Z25_ChamPciDomainMask = MEN_Z025_PCI_DOMAIN_MASK;
+#endif
+
       /* Initialize driver resources */
-      if( (z25DevP = Z25_InitDriver()) != NULL )
+#ifdef MEN_Z025_STATIC_MAP
+      z25DevP = Z25_InitDriverStatic(sysZ25StaticMap, NELEMENTS(sysZ25StaticMap));
+#else
+      z25DevP = Z25_InitDriver();
+#endif
+      if( z25DevP != NULL )
       {
            /* BSP specific offset for chameleon v2 devices */
            z25DevP->usePciIrq = MEN_Z025_USE_PCI_IRQ;
@@ -81,17 +130,34 @@ STATUS sysZ25Init(void)
 
            /* Set interrupt functions */
            Z25_SetIntFunctions(z25DevP, MEN_Z025_IRQ_BASE, MEN_Z025_INT_CONNECT_ROUTINE, MEN_Z025_INT_ENABLE_ROUTINE);
-           /* Find all quad UART units in the system */
+           /*
+            * Find all quad UART units in the system. The units of the
+            * paths are numbered consecutively, so the units of all paths
+            * (e.g. of several PCI domains) form one range.
+            */
            for( i=0; i<z25DevP->noPciPaths; i++ )
            {
+               unit = 0;
+               maxUnit = 0;
                if( Z25_FindUartUnits(z25DevP, i, &unit, &maxUnit) != 0 )
                {
-                   i = z25DevP->noPciPaths;
-                   maxUnit = 0;
+                   continue;
+               }
+               if( maxUnit == 0 )
+               {
+                   continue;
+               }
+               if( unit < firstUnit )
+               {
+                   firstUnit = unit;
+               }
+               if( (unit + maxUnit) > endUnit )
+               {
+                   endUnit = unit + maxUnit;
                }
            }
            /* Install all quad UART units */
-           for( j=unit; j<(unit+maxUnit); j++ )
+           for( j=firstUnit; j<endUnit; j++ )
            {
         /*------------------------------+
         | driver installation section  |
@@ -133,12 +199,21 @@ STATUS sysZ25Init(void)
                                         "/tyCo",
                                         j,
                                         i,
-                                        Z25_RX_BUFF_SIZE,
-                                        Z25_TX_BUFF_SIZE) != Z25_OK ){
+                                        Z25_BUFF_SIZE_AUTO,
+                                        Z25_BUFF_SIZE_AUTO) != Z25_OK ){
                 goto CLEANUP;
             }
         }
            }
+
+#ifdef MEN_Z025_STATIC_MAP
+           /* check the map against the hardware, boot is not delayed */
+           if( MEN_Z025_STATIC_VERIFY ){
+               taskSpawn("tZ25Verify", MEN_Z025_STATIC_VERIFY_PRIO, 0, 0x2000,
+                         (FUNCPTR)Z25_VerifyStaticMap,
+                         0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+           }
+#endif
       }
 
     CLEANUP:
@@ -19,6 +19,8 @@
  *   - MZ25_ModuleId
  *   - MZ25_InitHandle
  *   - MZ25_FreeHandle
+ *   - MZ25_InitUnit
+ *   - MZ25_ExitUnit
  *   - MZ25_EnableInterrupt
  *   - MZ25_DisableInterrupt
  *   - MZ25_SetBaudrate
@@ -44,6 +46,7 @@
  *   - MZ25_ControlModemTxInt
  *   - MZ25_SetModemControl
  *   - MZ25_GetModemControl
+ *   - MZ25_RestoreUnit
  *
  *-------------------------------[ History ]---------------------------------
  *
@@ -136,10 +139,8 @@ void MZ25_ModuleId(void){
 /**********************************************************************/
  /** Routine to initialize module handle
   *
-  *  This routine allocates the memory for the 16Z025 module handle.
-  *  All elements of the 16Z025 module structure are set to a
-  *  defined state. If debugging is enabled, the debug library will
-  *  be initialized.
+  *  This routine allocates the memory for the 16Z025 module handle
+  *  and initializes it by MZ25_InitUnit.
   *
   *	 \param hdlP			16Z025 handle
   *	 \param address			UART channel address
@@ -155,6 +156,68 @@ STATUS MZ25_InitHandle(HDL_16Z25 **hdlP, u_int32 address){
 		return MZ25_ERROR;
 	}
 
+	MZ25_InitUnit(mZ25P, address);
+
+	*hdlP = mZ25P;
+
+	return MZ25_OK;
+}/* MZ25_InitHandle */
+
+/**********************************************************************/
+ /** Routine to free module handle
+  *
+  *  This routine frees the memory, which was allocated by
+  *  MZ25InitHandle. If debugging is enbabled, the debug resources
+  *  will be freed, too.
+  *
+  *	 \param hdlP			16Z025 module handle
+  *
+  *  \return MZ25_OK or MZ25_ERROR
+ */
+STATUS MZ25_FreeHandle(HDL_16Z25 **hdlP){
+	TS_16Z25_UNIT *mZ25P;   /* 16Z025 resources */
+
+	mZ25P = *hdlP;
+
+	if( mZ25P == NULL ){
+		return MZ25_ERROR;
+	}
+
+	DBGWRT_1((mZ25P->dbgHdlP,
+		"MZ25_FreeHandle\n"));
+
+	MZ25_ExitUnit(mZ25P);
+
+	OSS_MemFree(NULL, (void *)mZ25P, sizeof(TS_16Z25_UNIT));
+	mZ25P = NULL;
+
+	*hdlP = mZ25P;
+
+	return MZ25_OK;
+}/* MZ25_FreeHandle */
+
+/**********************************************************************/
+ /** Routine to initialize a caller provided module handle
+  *
+  *  This routine sets all elements of the 16Z025 module structure to a
+  *  defined state without allocating memory. It is used by callers
+  *  which embed the TS_16Z25_UNIT structure in their own channel data,
+  *  e.g. the Z25 driver. If debugging is enabled, the debug library
+  *  will be initialized.
+  *
+  *	 \param hdlP			16Z025 module handle (TS_16Z25_UNIT memory)
+  *	 \param address			UART channel address
+  *
+  *  \return MZ25_OK or MZ25_ERROR
+ */
+STATUS MZ25_InitUnit(HDL_16Z25 *hdlP, u_int32 address){
+	TS_16Z25_UNIT *mZ25P;   /* 16Z025 resources */
+
+	if( hdlP == NULL ){
+		return MZ25_ERROR;
+	}
+	mZ25P = hdlP;
+
 	mZ25P->address = address;
  	mZ25P->baudrate = 0;
 	mZ25P->stopbits = 0;
@@ -177,48 +240,38 @@ STATUS MZ25_InitHandle(HDL_16Z25 **hdlP, u_int32 address){
 	mZ25P->rtsCtsHs = FALSE;
 	mZ25P->uartFreq = 1843200;
 	mZ25P->divisorConst = 16;
+	mZ25P->dbgHdlP = NULL;
 
 	DBGINIT(("16Z025Unit", (DBG_HANDLE **)&mZ25P->dbgHdlP));
 
-    DBGWRT_1((mZ25P->dbgHdlP, "MZ25_InitHandle \n"));
-
-	*hdlP = mZ25P;
+    DBGWRT_1((mZ25P->dbgHdlP, "MZ25_InitUnit \n"));
 
 	return MZ25_OK;
-}/* MZ25_InitHandle */
+}/* MZ25_InitUnit */
 
 /**********************************************************************/
- /** Routine to free module handle
+ /** Routine to release a caller provided module handle
   *
-  *  This routine frees the memory, which was allocated by
-  *  MZ25InitHandle. If debugging is enbabled, the debug resources
-  *  will be freed, too.
+  *  This routine is the counterpart of MZ25_InitUnit. It frees the
+  *  debug resources only, the memory of the handle stays with the
+  *  caller.
   *
   *	 \param hdlP			16Z025 module handle
   *
   *  \return MZ25_OK or MZ25_ERROR
  */
-STATUS MZ25_FreeHandle(HDL_16Z25 **hdlP){
+STATUS MZ25_ExitUnit(HDL_16Z25 *hdlP){
 	TS_16Z25_UNIT *mZ25P;   /* 16Z025 resources */
 
-	mZ25P = *hdlP;
-
-	if( mZ25P == NULL ){
+	if( hdlP == NULL ){
 		return MZ25_ERROR;
 	}
-
-	DBGWRT_1((mZ25P->dbgHdlP,
-		"MZ25_FreeHandle\n"));
+	mZ25P = hdlP;
 
 	DBGEXIT((&mZ25P->dbgHdlP));
 
-	OSS_MemFree(NULL, (void *)mZ25P, sizeof(TS_16Z25_UNIT));
-	mZ25P = NULL;
-
-	*hdlP = mZ25P;
-
 	return MZ25_OK;
-}/* MZ25_FreeHandle */
+}/* MZ25_ExitUnit */
 
 /**********************************************************************/
  /** Routine to set the baudrate
@@ -1496,6 +1549,53 @@ BOOL MZ25_GetModemControl(HDL_16Z25 *hdlP){
 
     return tmphdlP->modemControl;
 } /* MZ25_GetModemControl */
+
+/**********************************************************************/
+ /** Routine to write the stored settings to the UART registers
+  *
+  *  This routine programs the line parameters, the baudrate, the Rx FIFO
+  *  trigger level and the modem control lines from the values stored in
+  *  the module handle. It is used to bring up a channel whose settings
+  *  have been prepared without hardware access. The UART interrupts are
+  *  left disabled, they must be enabled by the caller.
+  *
+  *	 \param hdlP			16Z025 module handle
+  *
+  *  \return MZ25_OK or MZ25_ERROR
+ */
+STATUS MZ25_RestoreUnit(HDL_16Z25 *hdlP){
+    TS_16Z25_UNIT *tmphdlP;  /* 16Z025 resources */
+
+    if( hdlP == NULL ){
+        return MZ25_ERROR;
+    }
+    else{
+        tmphdlP = hdlP;
+    }
+
+    DBGWRT_1((tmphdlP->dbgHdlP,
+		"MZ25_RestoreUnit\n"));
+
+    MZ25_DisableInterrupt(hdlP, 0);
+
+    MZ25_SetSerialParameter(hdlP, (tmphdlP->stopbits |
+                                   tmphdlP->databits |
+                                   tmphdlP->parity));
+    if( tmphdlP->baudrate != 0 ){
+        MZ25_SetBaudrate(hdlP, tmphdlP->baudrate);
+    }
+    MZ25_SetFifoTriggerLevel(hdlP, 0, tmphdlP->fifoRxTrigger);
+
+    MZ25_SetRts(hdlP, tmphdlP->rts);
+    MZ25_SetDtr(hdlP, tmphdlP->dtr);
+    MZ25_SetOut1(hdlP, tmphdlP->out1);
+    MZ25_SetOut2(hdlP, tmphdlP->out2);
+    if( tmphdlP->rtsCtsHs ){
+        MZ25_EnableAutoRtsCts(hdlP, TRUE);
+    }
+
+    return MZ25_OK;
+} /* MZ25_RestoreUnit */
 /*! @} */
 
 
@@ -11,21 +11,31 @@
  *                This module provides the exported 13Z025 functions for the
  *                different initialization possibilities.
  *
- *     Switches: -
+ *     Switches: Z25_PROFILE - boot time profiling, see Z25_ProfileShow
  */
 /*---------------------------[ Public Functions ]----------------------------
  *
  * - Z25_DriverId
  * - Z25_InitDriver
+ * - Z25_InitDriverStatic
  * - Z25_CreateDevice
  * - Z25_SetIntFunctions
+ * - Z25_SetTimeBase
  * - Z25_InitDriverAtBoot
  * - Z25_FindUartUnits
  * - Z25_SetBaseBaud
  * - Z25_InstallTtyInterface
+ * - Z25_ChannelIoctl
+ * - Z25_BroadcastWrite
+ * - Z25_BondCreate
+ * - Z25_BondDelete
  * - Z25_GetPciPathInfo
  * - Z25_GetIosDriverNumber
  * - Z25_FreeHandle
+ * - Z25_RescanPci
+ * - Z25_VerifyStaticMap
+ * - Z25_ProfileShow
+ * - Z25_ProfileClear
  * - Z25_SetDebugLevel
  * - Z25_GetDebugLevel
  *
@@ -212,6 +222,7 @@
 *  - Driver channels can be used as serial console at boot\n
 *  - Each PCI device can be installed separately via its PCI bus path\n
 *  - User-definable interrupt functions\n
+*  - Channel bonding: one stream striped across several channels\n
 *  - Possibility to activate debug output\n
 *  \n
 *  \section CHAP_2 2. Short Description
@@ -226,18 +237,45 @@
 *  Header file <em>Z25_driver.h</em> includes various defines which allow the
 *  user to adapt the driver to the system.\n
 *  \n
-*  - <b>Z25_MAX_PCI_DEV</b>:\n
-*  Limit maximum number of supported PCI devices\n
-*  <em><b>Default value:</b> 10</em>\n
+*  The PCI path and UART unit tables are not limited by defines. They are
+*  allocated by Z25_InitDriver according to the Chameleon devices and
+*  UART units found in the system (Z25_MAX_PCI_DEV and Z25_MAX_UNITS are
+*  obsolete).\n
 *  \n
-*  - <b>Z25_MAX_UNITS</b>: \n
-*  Maximum number of supported UART units per Chameleon device
-*  if initialization in BSP it represents the total number of
-*  UART units in the system\n
-*  <em><b>Default value:</b> 10</em>\n
+*  The discovery result is shared: the first Z25_InitDriver call scans the
+*  PCI bus, further calls (also from Z25_CreateDevice and Z25_MdisDriver)
+*  return the same handle and increment its reference count. Z25_FreeHandle
+*  releases one reference. Z25_RescanPci adds Chameleon devices which
+*  appeared after the first scan (e.g. a reloaded FPGA). Their units use
+*  the IZ25_UNIT_TABLE_SPARE spare entries of the unit tables, more units
+*  can only be added as long as no channel is created.\n
+*  \n
+*  On systems with a fixed hardware configuration Z25_InitDriverStatic
+*  creates the handle from a table of Chameleon FPGA locations (configlette:
+*  MEN_Z025_STATIC_MAP), optionally with their UART units, so no PCI bus
+*  scan is done at boot. Z25_VerifyStaticMap compares the table with the
+*  hardware, e.g. from a low priority task after boot.\n
+*  \n
+*  Z25_InstallTtyInterface only registers the device names. The UART
+*  registers of a tty channel are programmed and its interrupt is enabled
+*  at the first open of the channel, so unused channels are never touched.
+*  Channels initialized with Z25_InitDriverAtBoot are set up at once.\n
+*  \n
+*  Z25_BondCreate bonds several tty channels of a unit to one device for
+*  bulk transfers between two boards. The data is striped across the
+*  channels in sequence numbered chunks and reassembled in order by the
+*  receiving side. Z25_BondDelete removes the device again.\n
+*  \n
+*  Compiled with the switch <b>Z25_PROFILE</b> (configlette:
+*  Z025_PROFILE_DRIVER), the driver measures time, PCI config reads and
+*  UART register accesses of its discovery and installation phases.
+*  Z25_ProfileShow prints the summary, e.g. from the shell after boot. The
+*  BSP must provide the timestamp driver (INCLUDE_TIMESTAMP).\n
 *  \n
 *  - <b>Z25_RX_BUFF_SIZE / Z25_TX_BUFF_SIZE</b>: \n
-*  Receive/send buffer size for each UART channel\n
+*  Minimum receive/send buffer size for each UART channel. Buffers
+*  installed with Z25_BUFF_SIZE_AUTO hold Z25_BUFF_AUTO_MS of data at
+*  the channel baudrate\n
 *  <em><b>Default value:</b> 512</em>\n
 *  \n
 *  \subsection CHAP_21 Supported I/O Controls
@@ -285,6 +323,52 @@
 *  Set Tx FIFO trigger level of uart.
 *  Z025: up to 60 bytes, <em>value=1..60</em>\n
 *  Z125: up to 116 bytes, <em>value=1..116</em>\n
+*  - MEN_UART_IOCTL_SET_RX_BUFF_SIZE / MEN_UART_IOCTL_SET_TX_BUFF_SIZE\n
+*  Resize the software Rx/Tx buffer of an idle channel (opened once,
+*  buffers empty), <em>value=size in bytes, 0=derived from baudrate</em>.
+*  Fails with errno EBUSY if the channel is not idle.\n
+*  - MEN_UART_IOCTL_GET_RX_BUFF_SIZE / MEN_UART_IOCTL_GET_TX_BUFF_SIZE\n
+*  Get the software Rx/Tx buffer size, <em>value=pointer to u_int32</em>\n
+*  - MEN_UART_IOCTL_RTS_CTS / MEN_UART_IOCTL_XON_XOFF / MEN_UART_IOCTL_DTR_DSR\n
+*  Select the flow control, <em>value=1(activate) or 0(no flow control)</em>.
+*  XON/XOFF is only available for the tty interface.\n
+*  - MEN_UART_IOCTL_FLOW_CONTROL\n
+*  Select the flow control, <em>value=MEN_UART_FLOW_x</em>\n
+*  - MEN_UART_IOCTL_POLL_MODE\n
+*  Serve the channel by polling instead of interrupts (tty interface only),
+*  <em>value=poll period in ticks, 0=interrupt mode</em>\n
+*  - MEN_UART_IOCTL_RX_TIMESTAMP\n
+*  Stamp the start of each Rx burst, <em>value=1(activate) or 0(deactivate)</em>\n
+*  - MEN_UART_IOCTL_GET_RX_TIMESTAMP\n
+*  Get the last Rx burst stamp, <em>value=pointer to MEN_UART_RX_TIMESTAMP</em>\n
+*  - MEN_UART_IOCTL_STATS\n
+*  Count Rx/Tx bytes, bursts and errors, <em>value=1(activate) or 0(deactivate)</em>\n
+*  - MEN_UART_IOCTL_GET_STATS / MEN_UART_IOCTL_CLEAR_STATS\n
+*  Get or clear the counters, <em>value=pointer to MEN_UART_STATS</em>\n
+*  - MEN_UART_IOCTL_FRAMER\n
+*  Set the Rx framer (tty interface only), read() then returns one
+*  delimiter, length, COBS or Modbus RTU frame per call,
+*  <em>value=pointer to MEN_UART_FRAMER, NULL=byte stream</em>\n
+*  - MEN_UART_IOCTL_TRANSACTION\n
+*  Write a request and collect the response at driver level (tty interface
+*  only), returns once the response is complete or the timeout expired
+*  (errno ETIMEDOUT), <em>value=pointer to MEN_UART_TRANSACTION</em>\n
+*  - MEN_UART_IOCTL_WRITEV\n
+*  Queue caller owned Tx buffers, the transmit interrupt feeds the FIFO
+*  directly from them and signals each drained buffer (tty interface only).
+*  Kernel callers only, the buffers and semaphores are used at interrupt
+*  level. FIOFLUSH, FIOWFLUSH and the last close cancel queued buffers.
+*  Z25_BroadcastWrite uses the same queues to send one buffer on several
+*  channels, <em>value=pointer to MEN_UART_WRITEV</em>\n
+*  - MEN_UART_IOCTL_WRITE_URGENT\n
+*  Send a message through the high priority Tx queue, it is sent before
+*  all other queued data. Fails with errno EAGAIN if the queue is full,
+*  <em>value=pointer to MEN_UART_URGENT</em>\n
+*  - MEN_UART_IOCTL_WRITE_AT\n
+*  Send a message at an absolute time of the time base (see
+*  Z25_SetTimeBase, ENOSYS without), returns when the message is loaded
+*  into the FIFO or with errno ETIMEDOUT (kernel callers only),
+*  <em>value=pointer to MEN_UART_TIMED_TX</em>\n
 *  <b>Standard VxWorks controls:</b>\n
 *  - SIO_BAUD_SET, <em>value=decimal baud-rate value, e.g. 9600</em>\n
 *  - FIOBAUDRATE, <em>value=decimal baud-rate value, e.g. 9600</em>\n
@@ -296,6 +380,9 @@
 *  - SIO_MCTRL_BITS_CLR, <em>clears modem signal(s) specified in argument</em>\n
 *  - SIO_MCTRL_OSIG_MASK, <em>returns mask of all input modem signals</em>\n
 *  - SIO_MCTRL_ISIG_MASK, <em>returns mask of all output(writable) modem signals</em>\n
+*  - SIO_MODE_SET, <em>SIO_MODE_INT or SIO_MODE_POLL (SIO channels only)</em>\n
+*  - SIO_MODE_GET, <em>value=pointer to int, gets the current mode</em>\n
+*  - SIO_AVAIL_MODES_GET, <em>value=pointer to int, gets the available modes</em>\n
 * \n
 *  \subsection CHAP_22 Supported System Calls
 *  - <em><b>open(name, mode, 0):</b></em> open a device (create a handle to the device)\n
@@ -653,6 +740,12 @@
 #include "usrLib.h"
 #include "errnoLib.h"
 #include "tyLib.h"
+#include "memLib.h"
+#include "semLib.h"
+#include "wdLib.h"
+#include "msgQLib.h"
+#include "selectLib.h"
+#include "excLib.h"
 
 #include <vxBusLib.h>
 #include <tickLib.h>
@@ -660,6 +753,9 @@
 #include <vxbus/vxbPciBus.h>
 /* Standard VxWorks driver libraries */
 #include "drv/pci/pciConfigLib.h"   /* for PCI const */
+#if defined(Z25_PROFILE) || defined(INCLUDE_TIMESTAMP)
+#include "drv/timer/timestampDev.h" /* for sysTimestamp */
+#endif
 #include "drv/pci/pciIntLib.h"      /* for PCI interrupt */
 
 /* Standard ANSI libraries */
@@ -692,8 +788,10 @@
 #define VERBOSITY_2		0x3
 #define VERBOSITY_3		0x7
 
-#define NR_MAX_DOMAINS	3   		/* currently on QorIQ P10/20xx */
+#define LZ25_MAX_DOMAINS	(32)	/* bits of G_Z25_ChamPciDomainMask */
+#define LZ25_SCAN_TASK_STACK   (0x2000)  /* stack of domain scan tasks */
 
+#define LZ25_CREATE_TYPE_NONE          (0)
 #define LZ25_CREATE_TYPE_AT_BOOT       (1)
 #define LZ25_CREATE_TYPE_LATE          (2)
 #define LZ25_MAX_PCI_DEV_NO            (32)
@@ -723,24 +821,78 @@ IMPORT UINT8 *sysInumTbl;
 /*--------------------------------------*/
 /* Z25 resource handling */
 LOCAL STATUS LocInitHandle(Z25_HDL **hdlP);
+LOCAL STATUS LocSharedLock(void);
+LOCAL void LocSharedUnlock(void);
+LOCAL STATUS LocChanLock(Z25_TY_CO_DEV_TS *chanP);
+LOCAL void LocChanUnlock(Z25_TY_CO_DEV_TS *chanP);
+LOCAL void *LocChanResGet(Z25_TY_CO_DEV_TS *chanP,
+                          void **resPP,
+                          void *(*createFct)(Z25_TY_CO_DEV_TS *chanP));
+LOCAL void *LocTransCreate(Z25_TY_CO_DEV_TS *chanP);
+LOCAL void *LocTxDescQCreate(Z25_TY_CO_DEV_TS *chanP);
+LOCAL void *LocUrgentCreate(Z25_TY_CO_DEV_TS *chanP);
+LOCAL void *LocTimedCreate(Z25_TY_CO_DEV_TS *chanP);
 
 /* PCI bus related functions */
-LOCAL STATUS LocScanPciDevices(Z25_PCI_SCAN_TS **pciDevicesP,
+LOCAL int32 LocPciCfgRead(u_int32 *cfgReadsP,
+                          u_int8 pciDomain,
+                          int32 bus,
+                          int32 dev,
+                          int32 fct,
+                          int32 which,
+                          int32 *valueP);
+
+LOCAL void LocScanPciBus(u_int32 *cfgReadsP,
+                         u_int8 pciDomain,
+                         int32 busNo,
+                         u_int8 depth,
+                         Z25_PCI_BRIDGE_TS *bridgeMapP,
+                         Z25_PCI_SCAN_TS *pciDevicesP,
+                         u_int16 maxDevices,
+                         u_int16 *devCntP);
+
+LOCAL STATUS LocScanPciDevices(Z25_PCI_SCAN_TS *pciDevicesP,
+                               u_int16 maxDevices,
                                u_int16 *noPciDevicesP,
-                               u_int8 pciDomains);
+                               u_int8 pciDomain,
+                               Z25_PCI_BRIDGE_TS *bridgeMapP,
+                               u_int32 *cfgReadsP);
 
-LOCAL STATUS LocFindPciBridge(int32 pciDomain,
-							  int32 bus,
+LOCAL STATUS LocFindPciBridge(const Z25_PCI_BRIDGE_TS *bridgeMapP,
+                              int32 bus,
                               u_int8 *busP,
                               int32 *devP);
 
 LOCAL STATUS LocGetDevicePath(Z25_HDL *hdlP,
+                              const Z25_PCI_BRIDGE_TS *bridgeMapP,
                               u_int8 *devicePathP,
                               u_int8 *pathCountP,
                               u_int16 devIndex);
 
 /* Chameleon related functions */
-LOCAL STATUS LocFindChameleonDevices(Z25_HDL *hdlP, u_int8 pciDomain);
+LOCAL STATUS LocFindChameleonDevices(Z25_HDL *hdlP, u_int32 domainMask);
+LOCAL void LocScanDomain(Z25_DOMAIN_SCAN_TS *scanP);
+LOCAL u_int32 LocDomainMask(void);
+LOCAL STATUS LocParseChamTable(Z25_HDL *hdlP, u_int16 pathIndex);
+LOCAL Z25_CHAM_UNIT_TS *LocChamUnitGet(Z25_PATH_TS *pathP,
+                                       u_int16 modIdx,
+                                       u_int16 instance);
+LOCAL void LocFreeChamTable(Z25_PATH_TS *pathP);
+LOCAL STATUS LocFindPath(Z25_HDL *hdlP,
+                         u_int32 bus,
+                         u_int16 dev,
+                         u_int16 fct,
+                         u_int16 *pathIndexP);
+LOCAL STATUS LocStaticChamTable(Z25_HDL *hdlP,
+                                u_int16 pathIndex,
+                                const Z25_STATIC_DEV *sdP);
+LOCAL STATUS LocAddPath(Z25_HDL *hdlP,
+                        u_int32 bus,
+                        u_int16 dev,
+                        u_int16 fct,
+                        u_int16 *pathIndexP);
+LOCAL u_int16 LocCountUartUnits(Z25_HDL *hdlP);
+LOCAL STATUS LocAllocUnitTables(Z25_HDL *hdlP, u_int16 maxUnits);
 
 LOCAL STATUS LocInitUartUnit(Z25_HDL *hdlP,
                              u_int32 address,
@@ -751,12 +903,18 @@ LOCAL STATUS LocInitChannels(Z25_HDL *hdlP,
                            u_int16 unit,
                            u_int16 channel,
                            u_int8 createType);
+LOCAL STATUS LocBringUpChannel(Z25_TY_CO_DEV_TS *chanP);
+LOCAL STATUS LocEnableInterrupt(Z25_HDL *hdlP,
+                                u_int16 unit,
+                                u_int16 channel);
 
 LOCAL int LocCreate(Z25_TY_CO_DEV_TS *chanP,
                   int8 *name,
                   int mode);
 
 LOCAL int LocClose( Z25_TY_CO_DEV_TS *chanP );
+LOCAL int LocChanOpen( Z25_TY_CO_DEV_TS *chanP );
+LOCAL int LocRead(Z25_TY_CO_DEV_TS *chanP, char *bufP, int maxBytes);
 
 LOCAL int LocIoctl(Z25_TY_CO_DEV_TS *chanP,
                    int request,
@@ -764,8 +922,8 @@ LOCAL int LocIoctl(Z25_TY_CO_DEV_TS *chanP,
 
 LOCAL void LocStartup(Z25_TY_CO_DEV_TS *chanP);
 
-LOCAL void LocInterrupt(Z25_TY_CO_DEV_TS *chanP);
-LOCAL void LocInterruptRoutine(Z25_TY_CO_DEV_TS *chanP);
+LOCAL void LocInterrupt(Z25_ISR_UNIT_TS *isrP);
+LOCAL void LocInterruptRoutine(Z25_ISR_CHAN_TS *isrChanP);
 LOCAL void LocLineInt(Z25_TY_CO_DEV_TS *chanP);
 LOCAL void LocSioReceiveInt(Z25_TY_CO_DEV_TS *chanP);
 LOCAL void LocTyReceiveInt(Z25_TY_CO_DEV_TS *chanP);
@@ -782,7 +940,84 @@ LOCAL int LocCallbackInstall(
                     STATUS (*callback)(void *, ...),
                     void *callbackArg );
 
+LOCAL int LocSioPollInput(SIO_CHAN *sioChanP, char *thisChar);
+LOCAL int LocSioPollOutput(SIO_CHAN *sioChanP, char outChar);
+LOCAL int LocSioModeSet(Z25_TY_CO_DEV_TS *chanP, int mode);
+
 LOCAL int LocOptsSet(Z25_TY_CO_DEV_TS *chanP, u_int16 options);
+LOCAL int LocFlowCtrlSet(Z25_TY_CO_DEV_TS *chanP, u_int32 mode);
+LOCAL int LocPollSet(Z25_TY_CO_DEV_TS *chanP, u_int32 ticks);
+LOCAL void LocPollStop(Z25_TY_CO_DEV_TS *chanP);
+LOCAL void LocPoll(Z25_TY_CO_DEV_TS *chanP);
+
+LOCAL u_int32 LocBuffSizeAuto(u_int32 baudrate, u_int32 minSize);
+LOCAL BOOL LocBuffIdle(Z25_TY_CO_DEV_TS *chanP);
+LOCAL STATUS LocResizeBuffer(Z25_TY_CO_DEV_TS *chanP, BOOL tx, u_int32 size);
+
+LOCAL void LocFramerFree(Z25_FRAMER_TS *framerP);
+LOCAL Z25_FRAMER_TS *LocFramerGet(Z25_TY_CO_DEV_TS *chanP);
+LOCAL void LocFramerPut(Z25_TY_CO_DEV_TS *chanP, Z25_FRAMER_TS *framerP);
+LOCAL void LocFramerFlush(Z25_FRAMER_TS *framerP);
+LOCAL int LocFramerIoctl(Z25_TY_CO_DEV_TS *chanP, int request, void *pArg);
+LOCAL int LocFramerSet(Z25_TY_CO_DEV_TS *chanP, const MEN_UART_FRAMER *cfgP);
+LOCAL void LocFramerDone(Z25_TY_CO_DEV_TS *chanP, Z25_FRAMER_TS *framerP);
+LOCAL void LocFramerDrop(Z25_TY_CO_DEV_TS *chanP,
+                         Z25_FRAMER_TS *framerP,
+                         BOOL skip);
+LOCAL u_int32 LocFramerLength(Z25_FRAMER_TS *framerP);
+LOCAL void LocFramerRx(Z25_TY_CO_DEV_TS *chanP,
+                       Z25_FRAMER_TS *framerP,
+                       const u_int8 *dataP,
+                       u_int32 len);
+LOCAL u_int32 LocFramerTicks(Z25_TY_CO_DEV_TS *chanP, u_int32 bits);
+LOCAL void LocFramerRtuEnd(Z25_TY_CO_DEV_TS *chanP, Z25_FRAMER_TS *framerP);
+LOCAL void LocFramerRtuWd(Z25_TY_CO_DEV_TS *chanP);
+LOCAL void LocFramerRxEnd(Z25_TY_CO_DEV_TS *chanP, BOOL idle);
+
+LOCAL u_int32 LocMsToTicks(u_int32 ms);
+LOCAL int LocTransaction(Z25_TY_CO_DEV_TS *chanP, MEN_UART_TRANSACTION *reqP);
+LOCAL void LocTransRx(Z25_TY_CO_DEV_TS *chanP,
+                      Z25_TRANS_TS *transP,
+                      u_int8 inByte);
+LOCAL void LocTransWd(Z25_TY_CO_DEV_TS *chanP);
+LOCAL Z25_TX_DESC_Q_TS *LocTxDescQGet(Z25_TY_CO_DEV_TS *chanP);
+LOCAL int LocTxDescQueue(Z25_TY_CO_DEV_TS *chanP, MEN_UART_WRITEV *wvP);
+LOCAL void LocTxDescCancel(Z25_TY_CO_DEV_TS *chanP);
+LOCAL int LocUrgentWrite(Z25_TY_CO_DEV_TS *chanP, MEN_UART_URGENT *msgP);
+LOCAL u_int8 LocUrgentTx(Z25_TY_CO_DEV_TS *chanP, u_int8 fifoBytes);
+LOCAL int LocTimedWrite(Z25_TY_CO_DEV_TS *chanP, MEN_UART_TIMED_TX *reqP);
+LOCAL void LocTimedFire(Z25_TY_CO_DEV_TS *chanP);
+LOCAL void LocTimedWait(Z25_TY_CO_DEV_TS *chanP, u_int32 txTime);
+LOCAL u_int8 LocTimedTx(Z25_TY_CO_DEV_TS *chanP, u_int8 fifoBytes);
+LOCAL u_int8 LocTxDescTx(Z25_TY_CO_DEV_TS *chanP,
+                         Z25_TX_DESC_Q_TS *qP,
+                         u_int8 fifoBytes);
+
+LOCAL void LocBondFree(Z25_BOND_TS *bondP);
+LOCAL int LocBondOpen(Z25_BOND_TS *bondP, char *name, int mode);
+LOCAL int LocBondClose(Z25_BOND_TS *bondP);
+LOCAL void LocBondRts(Z25_BOND_TS *bondP, BOOL on);
+LOCAL void LocBondRxWd(Z25_BOND_TS *bondP);
+LOCAL int LocBondRead(Z25_BOND_TS *bondP, char *bufP, int maxBytes);
+LOCAL int LocBondWrite(Z25_BOND_TS *bondP, char *bufP, int nBytes);
+LOCAL int LocBondIoctl(Z25_BOND_TS *bondP, int request, void *arg);
+LOCAL u_int16 LocBondCrc(u_int16 crc, const u_int8 *dataP, u_int32 len);
+LOCAL void LocBondRx(Z25_TY_CO_DEV_TS *chanP,
+                     Z25_BOND_TS *bondP,
+                     const u_int8 *dataP,
+                     u_int32 len);
+LOCAL void LocBondChunk(Z25_BOND_TS *bondP,
+                        Z25_BOND_MEMBER_TS *memberP,
+                        u_int16 seq,
+                        const u_int8 *dataP,
+                        u_int16 len);
+LOCAL void LocBondAdvance(Z25_BOND_TS *bondP);
+LOCAL void LocBondDeliver(Z25_BOND_TS *bondP);
+
+#ifdef Z25_PROFILE
+LOCAL Z25_PROF_MARK_TS LocProfStart(void);
+LOCAL void LocProfStop(Z25_PROF_MARK_TS *markP, u_int32 phase);
+#endif
 
 LOCAL int LocMstatGet (Z25_TY_CO_DEV_TS *);
 LOCAL int LocMstatSetClr (Z25_TY_CO_DEV_TS *, UINT bits, BOOL setFlag);
@@ -821,9 +1056,47 @@ LOCAL const u_int16 G_modId[] = {
 LOCAL const SIO_DRV_FUNCS G_sioDrvFuncs ={
     (void*)LocIoctl,                    /* ioctl            */
     (void*)LocStartup,                  /* txStartup        */
-    (void*)LocCallbackInstall           /* callbackInstall  */
+    (void*)LocCallbackInstall,          /* callbackInstall  */
+    (void*)LocSioPollInput,             /* pollInput        */
+    (void*)LocSioPollOutput             /* pollOutput       */
 }; /* G_sioDrvFuncs */
 
+/* Modbus RTU CRC16 (polynomial 0xA001, reflected) */
+LOCAL const u_int16 G_crc16Table[256] = {
+    0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241,
+    0xc601, 0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1, 0xc481, 0x0440,
+    0xcc01, 0x0cc0, 0x0d80, 0xcd41, 0x0f00, 0xcfc1, 0xce81, 0x0e40,
+    0x0a00, 0xcac1, 0xcb81, 0x0b40, 0xc901, 0x09c0, 0x0880, 0xc841,
+    0xd801, 0x18c0, 0x1980, 0xd941, 0x1b00, 0xdbc1, 0xda81, 0x1a40,
+    0x1e00, 0xdec1, 0xdf81, 0x1f40, 0xdd01, 0x1dc0, 0x1c80, 0xdc41,
+    0x1400, 0xd4c1, 0xd581, 0x1540, 0xd701, 0x17c0, 0x1680, 0xd641,
+    0xd201, 0x12c0, 0x1380, 0xd341, 0x1100, 0xd1c1, 0xd081, 0x1040,
+    0xf001, 0x30c0, 0x3180, 0xf141, 0x3300, 0xf3c1, 0xf281, 0x3240,
+    0x3600, 0xf6c1, 0xf781, 0x3740, 0xf501, 0x35c0, 0x3480, 0xf441,
+    0x3c00, 0xfcc1, 0xfd81, 0x3d40, 0xff01, 0x3fc0, 0x3e80, 0xfe41,
+    0xfa01, 0x3ac0, 0x3b80, 0xfb41, 0x3900, 0xf9c1, 0xf881, 0x3840,
+    0x2800, 0xe8c1, 0xe981, 0x2940, 0xeb01, 0x2bc0, 0x2a80, 0xea41,
+    0xee01, 0x2ec0, 0x2f80, 0xef41, 0x2d00, 0xedc1, 0xec81, 0x2c40,
+    0xe401, 0x24c0, 0x2580, 0xe541, 0x2700, 0xe7c1, 0xe681, 0x2640,
+    0x2200, 0xe2c1, 0xe381, 0x2340, 0xe101, 0x21c0, 0x2080, 0xe041,
+    0xa001, 0x60c0, 0x6180, 0xa141, 0x6300, 0xa3c1, 0xa281, 0x6240,
+    0x6600, 0xa6c1, 0xa781, 0x6740, 0xa501, 0x65c0, 0x6480, 0xa441,
+    0x6c00, 0xacc1, 0xad81, 0x6d40, 0xaf01, 0x6fc0, 0x6e80, 0xae41,
+    0xaa01, 0x6ac0, 0x6b80, 0xab41, 0x6900, 0xa9c1, 0xa881, 0x6840,
+    0x7800, 0xb8c1, 0xb981, 0x7940, 0xbb01, 0x7bc0, 0x7a80, 0xba41,
+    0xbe01, 0x7ec0, 0x7f80, 0xbf41, 0x7d00, 0xbdc1, 0xbc81, 0x7c40,
+    0xb401, 0x74c0, 0x7580, 0xb541, 0x7700, 0xb7c1, 0xb681, 0x7640,
+    0x7200, 0xb2c1, 0xb381, 0x7340, 0xb101, 0x71c0, 0x7080, 0xb041,
+    0x5000, 0x90c1, 0x9181, 0x5140, 0x9301, 0x53c0, 0x5280, 0x9241,
+    0x9601, 0x56c0, 0x5780, 0x9741, 0x5500, 0x95c1, 0x9481, 0x5440,
+    0x9c01, 0x5cc0, 0x5d80, 0x9d41, 0x5f00, 0x9fc1, 0x9e81, 0x5e40,
+    0x5a00, 0x9ac1, 0x9b81, 0x5b40, 0x9901, 0x59c0, 0x5880, 0x9841,
+    0x8801, 0x48c0, 0x4980, 0x8941, 0x4b00, 0x8bc1, 0x8a81, 0x4a40,
+    0x4e00, 0x8ec1, 0x8f81, 0x4f40, 0x8d01, 0x4dc0, 0x4c80, 0x8c41,
+    0x4400, 0x84c1, 0x8581, 0x4540, 0x8701, 0x47c0, 0x4680, 0x8641,
+    0x8201, 0x42c0, 0x4380, 0x8341, 0x4100, 0x81c1, 0x8081, 0x4040
+}; /* G_crc16Table */
+
 /*--------------------------------------+
 |   GLOBALS                             |
 +---------------------------------------*/
@@ -840,6 +1113,46 @@ IMPORT VXB_DEVICE_ID sysGetPciCtrlID(int instance);
 VXB_DEVICE_ID G_Z25_vxbDevID;
 u_int32 G_Z25_ChamPciDomain;
 
+/* PCI domains to seek chameleon devices, bit n = domain n.
+ * If 0, G_Z25_ChamPciDomain is used */
+u_int32 G_Z25_ChamPciDomainMask = 0;
+
+/* scan several PCI domains in parallel tasks */
+BOOL G_Z25_ParallelDomainScan = TRUE;
+
+/* number of PCI config space reads done by the driver */
+u_int32 G_Z25_PciCfgReads;
+
+#ifdef Z25_PROFILE
+/* number of UART register accesses, counted by MZ25_REG_READ/WRITE */
+u_int32 G_Z25_MmioAccesses;
+
+/* boot time profile of the driver phases */
+LOCAL Z25_PROF_TS G_Z25_Prof[IZ25_PROF_MAX];
+LOCAL const char *G_Z25_ProfName[IZ25_PROF_MAX] = {
+    "Z25_InitDriver",
+    "LocFindChameleonDevices",
+    "PCI domain scans",
+    "LocGetDevicePath",
+    "Z25_FindUartUnits",
+    "Z25_SetBaseBaud",
+    "Z25_InstallTtyInterface"
+};
+#endif /* Z25_PROFILE */
+
+/* discovery result shared by all Z25_InitDriver callers */
+LOCAL Z25_DEV_TS *G_Z25_SharedHdlP = NULL;
+LOCAL u_int32     G_Z25_SharedRefCnt = 0;
+LOCAL SEM_ID      G_Z25_SharedSemId = NULL;
+
+/* time base of MEN_UART_IOCTL_WRITE_AT, see Z25_SetTimeBase */
+LOCAL FUNCPTR     G_Z25_TimeGetP = NULL;
+LOCAL FUNCPTR     G_Z25_TimeAlarmP = NULL;
+LOCAL u_int32     G_Z25_TimeFreq = 0;
+
+/* i/o system driver of the bonded devices, see Z25_BondCreate */
+LOCAL int         G_Z25_BondDrvNum = 0;
+
 /*--------------------------------------*/
 /*    DEFINES                           */
 /*--------------------------------------*/
@@ -968,6 +1281,162 @@ LOCAL int LocOptsSet( Z25_TY_CO_DEV_TS *chanP,
     return retVal;
 }/* LocOptsSet */
 
+/**********************************************************************/
+/** Routine to set the flow control of a channel
+ *
+ *  This routine switches off the current flow control and enables the
+ *  given one. RTS/CTS is done by the UART (Z125 only), XON/XOFF by the
+ *  tyLib and DTR/DSR by the modem status interrupt.
+ *
+ *  \param chanP            pointer to channel
+ *  \param mode             MEN_UART_FLOW_x
+ *
+ *  \return OK, EIO if error or ENOSYS if not supported
+ */
+LOCAL int LocFlowCtrlSet( Z25_TY_CO_DEV_TS *chanP,
+                          u_int32 mode ){
+    int32 retVal = OK;
+    int opts;
+
+    if( (mode == MEN_UART_FLOW_XON_XOFF) &&
+        (chanP->created != LZ25_CREATE_TYPE_LATE) ){
+        return ENOSYS;
+    }
+
+    /* current mode off */
+    switch( chanP->flowCtrl ){
+        case MEN_UART_FLOW_RTS_CTS:
+            MZ25_EnableAutoRtsCts(chanP->unitHdlP, FALSE);
+            break;
+        case MEN_UART_FLOW_XON_XOFF:
+            opts = tyIoctl(&chanP->u.tyDev, FIOGETOPTIONS, 0);
+            tyIoctl(&chanP->u.tyDev, FIOSETOPTIONS, opts & ~OPT_TANDEM);
+            break;
+        case MEN_UART_FLOW_DTR_DSR:
+            MZ25_SetModemControl(chanP->unitHdlP, FALSE);
+            chanP->options |= CLOCAL;
+            break;
+        default:
+            break;
+    }
+    chanP->flowCtrl = MEN_UART_FLOW_NONE;
+
+    switch( mode ){
+        case MEN_UART_FLOW_NONE:
+            break;
+        case MEN_UART_FLOW_RTS_CTS:
+            if( MZ25_EnableAutoRtsCts(chanP->unitHdlP, TRUE) != OK ){
+                retVal = EIO;
+            }
+            break;
+        case MEN_UART_FLOW_XON_XOFF:
+            opts = tyIoctl(&chanP->u.tyDev, FIOGETOPTIONS, 0);
+            tyIoctl(&chanP->u.tyDev, FIOSETOPTIONS, opts | OPT_TANDEM);
+            break;
+        case MEN_UART_FLOW_DTR_DSR:
+            MZ25_SetModemControl(chanP->unitHdlP, TRUE);
+            MZ25_SetRts(chanP->unitHdlP, TRUE);
+            MZ25_SetDtr(chanP->unitHdlP, TRUE);
+            chanP->options &= ~CLOCAL;
+            break;
+        default:
+            retVal = EIO;
+            break;
+    }
+
+    if( retVal == OK ){
+        chanP->flowCtrl = (u_int8)mode;
+    }
+
+    return retVal;
+}/* LocFlowCtrlSet */
+
+/**********************************************************************/
+/** Routine to switch a tty channel between interrupt and poll mode
+ *
+ *  In poll mode the UART interrupts of the channel are disabled and
+ *  LocPoll serves the channel every 'ticks' system clock ticks. This
+ *  saves the interrupt load of channels with bulk traffic, at the cost
+ *  of latency. The modem status interrupt is not served in poll mode.
+ *  If the channel is not brought up yet, the mode is only stored. The
+ *  poll watchdog is deleted at the last close and created again at the
+ *  next open, Tx data left at the last close is sent after that open.
+ *
+ *  \param chanP            pointer to channel
+ *  \param ticks            poll period, 0 = interrupt mode
+ *
+ *  \return OK, EIO if error or ENOSYS if not supported
+ */
+LOCAL int LocPollSet( Z25_TY_CO_DEV_TS *chanP,
+                      u_int32 ticks ){
+    if( chanP->created != LZ25_CREATE_TYPE_LATE ){
+        return ENOSYS;
+    }
+
+    if( (ticks > 0) && (chanP->pollWd == NULL) ){
+        if( (chanP->pollWd = wdCreate()) == NULL ){
+            return EIO;
+        }
+    }
+
+    if( chanP->pollWd != NULL ){
+        wdCancel(chanP->pollWd);
+    }
+    chanP->pollTicks = ticks;
+
+    if( !chanP->hwInit ){
+        return OK;
+    }
+
+    if( ticks > 0 ){
+        MZ25_DisableInterrupt(chanP->unitHdlP, 0);
+        wdStart(chanP->pollWd, (int)ticks, (FUNCPTR)LocPoll, (int)chanP);
+    }
+    else {
+        /* connects the unit ISR if the channel was always polled */
+        if( LocEnableInterrupt(chanP->devHdlP, chanP->unitIdx,
+                               chanP->unit) != Z25_OK ){
+            return EIO;
+        }
+        if( chanP->uartUnit.modemControl == TRUE ){
+            MZ25_SetModemControl(chanP->unitHdlP, TRUE);
+        }
+        LocStartup(chanP);
+    }
+
+    return OK;
+}/* LocPollSet */
+
+/**********************************************************************/
+/** Routine to stop polling and delete the poll watchdog of a channel
+ *
+ *  LocPoll does not restart the watchdog while pollTicks is 0, so the
+ *  watchdog is stopped before it is deleted, even if LocPoll runs on
+ *  another CPU meanwhile. The poll period is kept for the next open.
+ *
+ *  \param chanP            pointer to channel
+ *
+ *  \return no return value
+ */
+LOCAL void LocPollStop( Z25_TY_CO_DEV_TS *chanP ){
+    u_int32 ticks = chanP->pollTicks;
+
+    if( chanP->pollWd == NULL ){
+        return;
+    }
+
+    chanP->pollTicks = 0;
+    wdCancel(chanP->pollWd);
+#ifdef _WRS_CONFIG_SMP
+    /* let a LocPoll already running on another CPU finish */
+    taskDelay(1);
+    wdCancel(chanP->pollWd);
+#endif /* _WRS_CONFIG_SMP */
+    wdDelete(chanP->pollWd);
+    chanP->pollWd = NULL;
+    chanP->pollTicks = ticks;
+}/* LocPollStop */
+
 /*******************************************************************************
 *
 * LocMstatGet - read device modem control line status
@@ -1055,7 +1524,11 @@ LOCAL int LocMstatSetClr
 /** Routine to install the SIO callback handler
  *
  *  This routine provides the function pointers for send and receive
- *  operation via the VxWorks SIO interface.
+ *  operation via the VxWorks SIO interface. Besides the per character
+ *  callbacks, block callbacks (Z25_SIO_CALLBACK_PUT_RCV_BLOCK/
+ *  Z25_SIO_CALLBACK_GET_TX_BLOCK) can be installed to move a whole FIFO
+ *  burst per call. They take precedence, a NULL block callback falls
+ *  back to the per character callback.
  *
  *  \param sioChanP         SIO channel resources
  *  \param callbackType     callback type (transmit or receive)
@@ -1081,6 +1554,14 @@ LOCAL int LocCallbackInstall(  SIO_CHAN *  sioChanP,
             chanP->u.sioT.putRcvChar   = (void*)callback;
             chanP->u.sioT.putRcvArg    = callbackArg;
             break;
+        case Z25_SIO_CALLBACK_PUT_RCV_BLOCK:
+            chanP->u.sioT.putRcvBlock    = (void*)callback;
+            chanP->u.sioT.putRcvBlockArg = callbackArg;
+            break;
+        case Z25_SIO_CALLBACK_GET_TX_BLOCK:
+            chanP->u.sioT.getTxBlock     = (void*)callback;
+            chanP->u.sioT.getTxBlockArg  = callbackArg;
+            break;
         default:
             retVal = ENOSYS;
             break;
@@ -1090,151 +1571,305 @@ LOCAL int LocCallbackInstall(  SIO_CHAN *  sioChanP,
 }/* LocCallbackInstall */
 
 /**********************************************************************/
-/** Routine to find PCI bridges
+/** Routine to poll the SIO channel for a received character
  *
- *  This routine searches for PCI bridges and their buses.
+ *  This routine is the SIO pollInput function, it is used in polled
+ *  mode (SIO_MODE_POLL) e.g. by WDB or the kernel debugger and never
+ *  blocks.
  *
- *  \param pciDomain    number of PCI domain
- *  \param bus          number of buses to scan
- *  \param busP         found bus number
- *  \param devP         found device number
+ *  \param sioChanP         SIO channel resources
+ *  \param thisChar         pointer to store the received character
  *
- *  \return Z25_OK or Z25_ERROR
+ *  \return OK or EAGAIN if no character is available
  */
-LOCAL STATUS  LocFindPciBridge(int32 pciDomain,
-							   int32 bus,
-                               u_int8 *busP,
-                               int32 *devP)
-{
-    int32  pciFunc = 0;        /* PCI function index */
-    int32  pciBus = 0;         /* PCI bus index */
-    int32  pciDevice = 0;      /* PCI device index */
-    int32  secondaryBus = 0;   /* secondary bus */
-    int32  primaryBus = 0;     /* primary bus */
-    int32  header = 0;         /* configuration header type */
-    int32  vendor = 0;        /* vendor ID */
-
-    /*------------------------------------------+
-    | search for PCI bridges and their buses   |
-    +------------------------------------------*/
-    for (pciBus = 0; pciBus < bus; pciBus++){
-        for (pciDevice = 0; pciDevice < LZ25_MAX_PCI_DEV_NO; pciDevice++){
-            for (pciFunc = 0; pciFunc < LZ25_MAX_PCI_FUNC_NO; pciFunc++){
-                /* read out vendor id */
-            	OSS_PciGetConfig(NULL, OSS_MERGE_BUS_DOMAIN(pciBus, pciDomain),
-							pciDevice, pciFunc, OSS_PCI_VENDOR_ID, &vendor);
-
-                /*---------------------------------------------------+
-                | only look at vendor ID field for existence check   |
-                | this field must exsist for every PCI device        |
-                | if 0xFFFF is returned, go to next device           |
-                +----------------------------------------------------*/
-                if (((vendor & 0x0000ffff) != 0x0000FFFF)){
-                    /*------------------------------+
-                    | read out header type          |
-                    | skip if not PCI_PCI bridge    |
-                    +-------------------------------*/
-                	OSS_PciGetConfig(NULL, OSS_MERGE_BUS_DOMAIN(pciBus, pciDomain),
-								pciDevice, pciFunc, OSS_PCI_HEADER_TYPE, &header);
-
-                    /* PCI to PCI bridge header found */
-                    if ((header & PCI_HEADER_TYPE_MASK) == PCI_HEADER_PCI_PCI) {
-                        /* read out secondary bus number */
-                    	OSS_PciGetConfig(NULL, OSS_MERGE_BUS_DOMAIN(pciBus, pciDomain),
-										pciDevice, pciFunc, OSS_PCI_SECONDARY_BUS, &secondaryBus);
-
-                        /* secondary bus available */
-                        if(secondaryBus == bus){
-                        	OSS_PciGetConfig(NULL,
-											OSS_MERGE_BUS_DOMAIN(pciBus, pciDomain),
-    										pciDevice,
-											pciFunc,
-											OSS_PCI_SECONDARY_BUS,
-											&primaryBus);
-
-                            /* bus number of PCI to PCI bridge */
-                            *busP = primaryBus;
-                            *devP = pciDevice;
-                            return Z25_OK;
-                        }
-                    }
+LOCAL int LocSioPollInput( SIO_CHAN *sioChanP,
+                           char *thisChar ){
+    Z25_TY_CO_DEV_TS *chanP = (Z25_TY_CO_DEV_TS *)sioChanP;
 
-                    if((header & PCI_HEADER_MULTI_FUNC) != PCI_HEADER_MULTI_FUNC){
-                        /* no multi function device, so we can stop this loop */
-                        pciFunc = LZ25_MAX_PCI_FUNC_NO;
-                        break;
-                    }
-                }
-            }
+    if( !MZ25_RECEIVE_STATUS(chanP->addr) ){
+        return EAGAIN;
+    }
+
+    *thisChar = (char)MZ25_READ_BYTE(chanP->addr);
+
+    return OK;
+}/* LocSioPollInput */
+
+/**********************************************************************/
+/** Routine to output a character in SIO polled mode
+ *
+ *  This routine is the SIO pollOutput function, it writes the character
+ *  if the transmit holding register is empty and never blocks.
+ *
+ *  \param sioChanP         SIO channel resources
+ *  \param outChar          character to transmit
+ *
+ *  \return OK or EAGAIN if the transmitter is busy
+ */
+LOCAL int LocSioPollOutput( SIO_CHAN *sioChanP,
+                            char outChar ){
+    Z25_TY_CO_DEV_TS *chanP = (Z25_TY_CO_DEV_TS *)sioChanP;
+
+    if( !(MZ25_LINE_STATUS(chanP->addr) & MIZ25_THEP) ){
+        return EAGAIN;
+    }
+
+    MZ25_WRITE_BYTE(chanP->addr, (u_int8)outChar);
+
+    return OK;
+}/* LocSioPollOutput */
+
+/**********************************************************************/
+/** Routine to switch a SIO channel between interrupt and polled mode
+ *
+ *  Entering SIO_MODE_POLL saves and clears the interrupt enable register
+ *  of the channel, SIO_MODE_INT restores it. The ISR of the unit stays
+ *  connected for the other channels.
+ *
+ *  \param chanP            pointer to channel
+ *  \param mode             SIO_MODE_INT or SIO_MODE_POLL
+ *
+ *  \return OK, EIO if invalid mode or ENOSYS if no SIO channel
+ */
+LOCAL int LocSioModeSet( Z25_TY_CO_DEV_TS *chanP,
+                         int mode ){
+    int lockKey;
+
+    if( chanP->created != LZ25_CREATE_TYPE_AT_BOOT ){
+        return ENOSYS;
+    }
+
+    if( (mode != SIO_MODE_INT) && (mode != SIO_MODE_POLL) ){
+        return EIO;
+    }
+
+    lockKey = intLock();
+    if( mode != chanP->u.sioT.mode ){
+        if( mode == SIO_MODE_POLL ){
+            chanP->u.sioT.intMask =
+                MZ25_DisableInterrupt(chanP->unitHdlP, 0);
+        }
+        else {
+            MZ25_EnableInterrupt(chanP->unitHdlP, chanP->u.sioT.intMask);
         }
+        chanP->u.sioT.mode = mode;
     }
-    return Z25_ERROR;
-} /* LocFindPciBridge */
+    intUnlock(lockKey);
+
+    return OK;
+}/* LocSioModeSet */
 
 /**********************************************************************/
-/** Routine to scan the PCI bus for devices
+/** Routine to read the PCI configuration space
  *
- *  This routine searches the PCI bus for devices with the given
- *  vendor id at startup.
+ *  Wrapper of OSS_PciGetConfig which counts the config cycles issued
+ *  by the driver. The domain scans may run in parallel, so each scan
+ *  counts into its own counter, the sum is added to G_Z25_PciCfgReads.
  *
- *  \param pciDevicesP         PCI bus information
- *  \param noPciDevicesP       number of found PCI devices
+ *  \param cfgReadsP    config read counter of the scan
+ *  \param pciDomain    number of PCI domain
+ *  \param bus          PCI bus number
+ *  \param dev          PCI device number
+ *  \param fct          PCI function number
+ *  \param which        OSS_PCI_xxx register
+ *  \param valueP       read value
+ *
+ *  \return OSS_PciGetConfig return value
+ */
+LOCAL int32 LocPciCfgRead(u_int32 *cfgReadsP,
+                          u_int8 pciDomain,
+                          int32 bus,
+                          int32 dev,
+                          int32 fct,
+                          int32 which,
+                          int32 *valueP)
+{
+    (*cfgReadsP)++;
+
+    return OSS_PciGetConfig(NULL, OSS_MERGE_BUS_DOMAIN(bus, pciDomain),
+                            dev, fct, which, valueP);
+} /* LocPciCfgRead */
+
+/**********************************************************************/
+/** Routine to find PCI bridges
+ *
+ *  This routine looks up the PCI bridge in front of a bus in the bridge
+ *  map built by LocScanPciDevices.
+ *
+ *  \param bridgeMapP   bridge map (Z25_MAX_PCI_BUS_SEARCH entries)
+ *  \param bus          bus number to find the bridge for
+ *  \param busP         bus number the bridge is located on
+ *  \param devP         device number of the bridge
  *
  *  \return Z25_OK or Z25_ERROR
  */
-LOCAL STATUS LocScanPciDevices(Z25_PCI_SCAN_TS **pciDevicesP,
-								u_int16 *noPciDevicesP,
-								u_int8 pciDomain)
+LOCAL STATUS  LocFindPciBridge(const Z25_PCI_BRIDGE_TS *bridgeMapP,
+                               int32 bus,
+                               u_int8 *busP,
+                               int32 *devP)
+{
+    if( (bus <= 0) || (bus >= Z25_MAX_PCI_BUS_SEARCH) ||
+        !bridgeMapP[bus].valid ){
+        return Z25_ERROR;
+    }
+
+    *busP = bridgeMapP[bus].parentBus;
+    *devP = bridgeMapP[bus].deviceNo;
+
+    return Z25_OK;
+} /* LocFindPciBridge */
+
+/**********************************************************************/
+/** Routine to walk one PCI bus
+ *
+ *  This routine probes all devices of a PCI bus. Multi function devices
+ *  are probed on all functions. Functions with a supported vendor id are
+ *  stored in the device array. For every PCI-to-PCI bridge the secondary
+ *  bus is entered in the bridge map and walked recursively (depth first).
+ *
+ *  \param cfgReadsP           config read counter of the scan
+ *  \param pciDomain           number of PCI domain
+ *  \param busNo               bus number to walk
+ *  \param depth               number of bridges in front of the bus
+ *  \param bridgeMapP          bridge map (Z25_MAX_PCI_BUS_SEARCH entries)
+ *  \param pciDevicesP         device array
+ *  \param maxDevices          number of entries in device array
+ *  \param devCntP             number of found devices, may exceed
+ *                             maxDevices (not stored then)
+ *
+ *  \return -
+ */
+LOCAL void LocScanPciBus(u_int32 *cfgReadsP,
+                         u_int8 pciDomain,
+                         int32 busNo,
+                         u_int8 depth,
+                         Z25_PCI_BRIDGE_TS *bridgeMapP,
+                         Z25_PCI_SCAN_TS *pciDevicesP,
+                         u_int16 maxDevices,
+                         u_int16 *devCntP)
 {
-    int32 busNo 	= 0;    /* bus number index 		 */
     int32 deviceNo 	= 0;    /* device number index 		 */
     int32 funcNo 	= 0;    /* function number index 	 */
+    int32 noFunc 	= 0;    /* number of functions to probe */
     int32 device 	= 0;    /* device ID 				 */
     int32 vendor 	= 0;    /* vendor ID 				 */
-    u_int16 devCnt = 0;
-    Z25_PCI_SCAN_TS *pciDevicesTmpP = NULL;
+    int32 header 	= 0;    /* configuration header type */
+    int32 secBus 	= 0;    /* secondary bus of bridge	 */
+    int32 subBus 	= 0;    /* subordinate bus of bridge */
+    Z25_PCI_SCAN_TS *pciDevP = NULL;
+
+    bridgeMapP[busNo].scanned = TRUE;
 
-    for (busNo=0; busNo < Z25_MAX_PCI_BUS_SEARCH; busNo++)
+    for (deviceNo=0; deviceNo < LZ25_MAX_PCI_DEV_NO; deviceNo++)
     {
-        for (deviceNo=0; deviceNo < LZ25_MAX_PCI_DEV_NO; deviceNo++)
+        noFunc = 1;
+        for (funcNo=0; funcNo < noFunc; funcNo++)
         {
-            OSS_PciGetConfig(NULL, OSS_MERGE_BUS_DOMAIN(busNo, pciDomain), deviceNo, funcNo, OSS_PCI_VENDOR_ID, &vendor);
-            OSS_PciGetConfig(NULL, OSS_MERGE_BUS_DOMAIN(busNo, pciDomain), deviceNo, funcNo, OSS_PCI_DEVICE_ID, &device);
+            LocPciCfgRead(cfgReadsP, pciDomain, busNo, deviceNo, funcNo, OSS_PCI_VENDOR_ID, &vendor);
+            if( (vendor & 0xffff) == 0xffff ){
+                continue;
+            }
+            LocPciCfgRead(cfgReadsP, pciDomain, busNo, deviceNo, funcNo, OSS_PCI_HEADER_TYPE, &header);
+            if( (funcNo == 0) &&
+                ((header & PCI_HEADER_MULTI_FUNC) == PCI_HEADER_MULTI_FUNC) ){
+                noFunc = LZ25_MAX_PCI_FUNC_NO;
+            }
 
             /* check if valid vendor ID */
             if( vendor == CHAMELEON_PCI_VENID_MEN || vendor == CHAMELEON_PCI_VENID_ALTERA )
             {
-            	if( devCnt == 0 ){
-            		pciDevicesTmpP = malloc(sizeof(Z25_PCI_SCAN_TS));
-            		if ( pciDevicesTmpP == NULL ) { /* KlocWork Finding */
-            			*pciDevicesP = NULL;
-            			return Z25_ERROR;
-            		}
-            		*pciDevicesP = pciDevicesTmpP;
-				} else {
-                    pciDevicesTmpP->nextP = malloc(sizeof(Z25_PCI_SCAN_TS));
-                    if ( pciDevicesTmpP->nextP == NULL ) { /* KlocWork Finding */
-                	    pciDevicesTmpP = NULL;
-                	    return Z25_ERROR;
-                    }
-                    pciDevicesTmpP = (Z25_PCI_SCAN_TS *)pciDevicesTmpP->nextP;
+                LocPciCfgRead(cfgReadsP, pciDomain, busNo, deviceNo, funcNo, OSS_PCI_DEVICE_ID, &device);
+                if( *devCntP < maxDevices ){
+                    pciDevP = &pciDevicesP[*devCntP];
+                    pciDevP->vendorId 	= vendor;
+                    pciDevP->deviceId 	= device;
+                    pciDevP->busNo 		= (u_int8)(busNo 	&  0x000000ff);
+                    pciDevP->deviceNo 	= (u_int8)(deviceNo &  0x000000ff);
+                    pciDevP->funcNo 	= (u_int8)(funcNo 	&  0x000000ff);
                 }
+                (*devCntP)++;
+            }
 
-                if( pciDevicesTmpP != NULL ){
-                	bzero((char *)pciDevicesTmpP, sizeof(Z25_PCI_SCAN_TS));
+            /* follow PCI-to-PCI bridges */
+            if( (header & PCI_HEADER_TYPE_MASK) != PCI_HEADER_PCI_PCI ){
+                continue;
+            }
+            LocPciCfgRead(cfgReadsP, pciDomain, busNo, deviceNo, funcNo, OSS_PCI_SECONDARY_BUS, &secBus);
+            LocPciCfgRead(cfgReadsP, pciDomain, busNo, deviceNo, funcNo, OSS_PCI_SUBORDINATE_BUS, &subBus);
+            secBus &= 0xff;
+            subBus &= 0xff;
+
+            /* skip unconfigured bridges and already walked buses */
+            if( (secBus <= busNo) || (subBus < secBus) ||
+                (secBus >= Z25_MAX_PCI_BUS_SEARCH) ||
+                bridgeMapP[secBus].scanned ){
+                continue;
+            }
 
-                	devCnt ++;
-                	pciDevicesTmpP->vendorId 	= vendor;
-                	pciDevicesTmpP->deviceId 	= device;
-                	pciDevicesTmpP->busNo 		= (u_int8)(busNo 	&  0x000000ff);
-                	pciDevicesTmpP->deviceNo 	= (u_int8)(deviceNo &  0x000000ff);
-                	pciDevicesTmpP->funcNo 		= (u_int8)(funcNo 	&  0x000000ff);
-                	pciDevicesTmpP->nextP 		= NULL;
-                }
+            bridgeMapP[secBus].valid     = TRUE;
+            bridgeMapP[secBus].parentBus = (u_int8)busNo;
+            bridgeMapP[secBus].deviceNo  = (u_int8)deviceNo;
+
+            if( depth < (IZ25_PATH_LENGTH-1) ){
+                LocScanPciBus(cfgReadsP, pciDomain, secBus, (u_int8)(depth + 1),
+                              bridgeMapP, pciDevicesP, maxDevices, devCntP);
+            }
+        }
+    }
+}/* LocScanPciBus */
+
+/**********************************************************************/
+/** Routine to scan the PCI bus for devices
+ *
+ *  This routine searches the PCI bus for devices with the given
+ *  vendor id at startup. The bus hierarchy is walked from bus 0 along
+ *  the PCI-to-PCI bridges, so only existing buses are probed. On the
+ *  way, the bridge map is built which is used to derive the device
+ *  paths without scanning the bus again.
+ *
+ *  Only if the walk finds no device, the buses not reached by it are
+ *  probed as root buses, e.g. for an FPGA behind a further host bridge.
+ *  This fallback costs a full bus sweep. Devices beyond maxDevices are
+ *  reported and ignored.
+ *
+ *  \param pciDevicesP         device array
+ *  \param maxDevices          number of entries in device array
+ *  \param noPciDevicesP       number of found PCI devices
+ *  \param pciDomain           number of PCI domain
+ *  \param bridgeMapP          bridge map (Z25_MAX_PCI_BUS_SEARCH entries)
+ *  \param cfgReadsP           config read counter of the scan
+ *
+ *  \return Z25_OK or Z25_ERROR
+ */
+LOCAL STATUS LocScanPciDevices(Z25_PCI_SCAN_TS *pciDevicesP,
+								u_int16 maxDevices,
+								u_int16 *noPciDevicesP,
+								u_int8 pciDomain,
+								Z25_PCI_BRIDGE_TS *bridgeMapP,
+								u_int32 *cfgReadsP)
+{
+    int32 busNo 	= 0;    /* bus number index 		 */
+    u_int16 devCnt = 0;
+
+    LocScanPciBus(cfgReadsP, pciDomain, 0, 0, bridgeMapP,
+                  pciDevicesP, maxDevices, &devCnt);
+
+    /* fallback: no device behind bus 0, probe the remaining buses */
+    if( devCnt == 0 ){
+        for (busNo=1; busNo < Z25_MAX_PCI_BUS_SEARCH; busNo++)
+        {
+            if( !bridgeMapP[busNo].scanned ){
+                LocScanPciBus(cfgReadsP, pciDomain, busNo, 0, bridgeMapP,
+                              pciDevicesP, maxDevices, &devCnt);
             }
         }
     }
 
+    if( devCnt > maxDevices ){
+        printf("*** Z25/Z125 - %d Chameleon devices found, only %d used ! ***\n",
+               devCnt, maxDevices);
+        devCnt = maxDevices;
+    }
 
     if( devCnt == 0 ){
         return Z25_ERROR;
@@ -1253,6 +1888,7 @@ LOCAL STATUS LocScanPciDevices(Z25_PCI_SCAN_TS **pciDevicesP,
  *  be used to access the desired FPGA module
  *
  *  \param hdlP         Z25 handle returned by Z25_Init
+ *  \param bridgeMapP   bridge map built by LocScanPciDevices
  *  \param devicePathP  device path of PCI device
  *  \param pathCountP   path length of PCI device
  *  \param devIndex     index of PCI device
@@ -1260,9 +1896,11 @@ LOCAL STATUS LocScanPciDevices(Z25_PCI_SCAN_TS **pciDevicesP,
  *  \return Z25_OK or Z25_ERROR
  */
 LOCAL STATUS LocGetDevicePath(Z25_HDL *hdlP,
+                              const Z25_PCI_BRIDGE_TS *bridgeMapP,
                               u_int8 *devicePathP,
                               u_int8 *pathCountP,
                               u_int16 devIndex){
+    IZ25_PROF_DECL
     int32 inBus = 0;        /* PCI bus to start scan*/
     int32 tmpDev = 0;       /* PCI device */
     u_int8 tmpBus = 0;      /* bus number of PCI bridge */
@@ -1271,7 +1909,7 @@ LOCAL STATUS LocGetDevicePath(Z25_HDL *hdlP,
     Z25_DEV_TS *z25HdlP;  /* Z25 resources */
 
     if( hdlP == NULL ){
-        return Z25_ERROR;
+        IZ25_PROF_RETURN(IZ25_PROF_DEVICE_PATH, Z25_ERROR);
     }
     else{
         z25HdlP = hdlP;
@@ -1280,7 +1918,7 @@ LOCAL STATUS LocGetDevicePath(Z25_HDL *hdlP,
     inBus = OSS_BUS_NBR(z25HdlP->pathInfo[devIndex].pci.bus);
     /* find all bridges to the way of the desired Chameleon device */
     do{
-        if( LocFindPciBridge(G_Z25_ChamPciDomain, inBus, &tmpBus, &tmpDev) != Z25_OK ){
+        if( LocFindPciBridge(bridgeMapP, inBus, &tmpBus, &tmpDev) != Z25_OK ){
             break;
         }
 
@@ -1288,7 +1926,7 @@ LOCAL STATUS LocGetDevicePath(Z25_HDL *hdlP,
         tmpPciPath[((*pathCountP-1) & 0xf)] = tmpDev; /* KlocWork Finding: limit index to 15 */
 
         inBus = tmpBus;
-    }while( (tmpBus != 0) | (*pathCountP > 16) );
+    }while( (tmpBus != 0) && (*pathCountP < (IZ25_PATH_LENGTH-1)) );
 
     j=*pathCountP;
 
@@ -1312,294 +1950,3141 @@ LOCAL STATUS LocGetDevicePath(Z25_HDL *hdlP,
     DBGWRT_2( (z25HdlP->dbgHdlP, ".\n") );
 
     DBGWRT_2( (z25HdlP->dbgHdlP, "<--- LocGetDevicePath\n"));
-    return Z25_OK;
+    IZ25_PROF_RETURN(IZ25_PROF_DEVICE_PATH, Z25_OK);
  }/* LocGetDevicePath */
 
 
+/**********************************************************************/
+/** Routine to get the PCI domains to scan
+ *
+ *  \return G_Z25_ChamPciDomainMask or the bit of G_Z25_ChamPciDomain
+ */
+LOCAL u_int32 LocDomainMask(void){
+    if( G_Z25_ChamPciDomainMask != 0 ){
+        return G_Z25_ChamPciDomainMask;
+    }
+
+    return (u_int32)1 << (G_Z25_ChamPciDomain % LZ25_MAX_DOMAINS);
+}/* LocDomainMask */
+
+/**********************************************************************/
+/** Routine to scan one PCI domain
+ *
+ *  This routine is the body of the domain scan tasks, it is also called
+ *  directly if the domains are scanned one after the other.
+ *
+ *  \param scanP        domain scan state
+ *
+ *  \return no return value
+ */
+LOCAL void LocScanDomain(Z25_DOMAIN_SCAN_TS *scanP){
+    scanP->status = LocScanPciDevices(scanP->pciDevicesP, IZ25_MAX_PCI_SCAN,
+                                      &scanP->noPciDevices, scanP->domain,
+                                      scanP->bridgeMapP, &scanP->cfgReads);
+
+    if( scanP->doneSem != NULL ){
+        semGive(scanP->doneSem);
+    }
+}/* LocScanDomain */
+
 /**********************************************************************/
 /** Routine to find Chameleon devices
  *
- *  This routine calls LocFindPciDevice and LocGetDevicePath to find
+ *  This routine calls LocScanPciDevices and LocGetDevicePath to find
  *  all Chameleon devices and to register their PCI path. Each supported
  *  vendor and device ID will be used to find valid devices.
  *
+ *  Every domain of domainMask is scanned independently. If more than one
+ *  domain is given and G_Z25_ParallelDomainScan is set, each domain is
+ *  scanned by an own task. The found devices of all domains are merged
+ *  into one path table, ordered by domain.
+ *
  *  \param hdlP         Z25 handle returned by Z25_Init
- *  \param pciDomain    optional: PCI ctrl. nr if FPGA resides on
- *                                multiple PCIe ctrl CPU. 0 by default
+ *  \param domainMask   PCI domains to scan (bit n = domain n)
  *
  *  \return Z25_OK or Z25_ERROR
  */
-LOCAL STATUS LocFindChameleonDevices(Z25_HDL *hdlP, u_int8 pciDomain){
+LOCAL STATUS LocFindChameleonDevices(Z25_HDL *hdlP, u_int32 domainMask){
+    IZ25_PROF_DECL
     int32  index = 0;          /* index */
     Z25_DEV_TS *z25HdlP;       /* Z25 resources */
     u_int32 i;                 /* for loop index */
     u_int16 k = 0;             /* while loop index */
-    Z25_PCI_SCAN_TS *pciDevicesP = NULL;
-    u_int32 *addrFreeP 			= NULL;
-    u_int16 noPciDevices 		= 0;
+    u_int16 d;                 /* domain index */
+    Z25_DOMAIN_SCAN_TS *scanP = NULL;   /* state of scanned domains */
+    Z25_PCI_SCAN_TS *pciDevP;
+    u_int16 noDomains 			= 0;
+    u_int16 noPaths 			= 0;
+    u_int32 gotSize 			= 0;
+    u_int32 scanSize 			= 0;
+#ifdef DBG
+    u_int32 cfgReads 			= G_Z25_PciCfgReads;
+#endif
+    int prio 					= 0;
+    BOOL parallel 				= FALSE;
+    STATUS retVal 				= Z25_ERROR;
+#ifdef Z25_PROFILE
+    Z25_PROF_MARK_TS scanMark;  /* whole scan, the tasks do not profile */
+#endif
 
     if( hdlP == NULL ){
-        return Z25_ERROR;
+        IZ25_PROF_RETURN(IZ25_PROF_FIND_CHAM, Z25_ERROR);
     }
     else{
         z25HdlP = hdlP;
     }
 
-    if (pciDomain > NR_MAX_DOMAINS)
-    	return Z25_ERROR;
+    for( d=0; d<LZ25_MAX_DOMAINS; d++ ){
+        if( domainMask & ((u_int32)1 << d) ){
+            noDomains++;
+        }
+    }
+    if( noDomains == 0 ){
+    	IZ25_PROF_RETURN(IZ25_PROF_FIND_CHAM, Z25_ERROR);
+    }
+
+    DBGWRT_1( (z25HdlP->dbgHdlP,
+        "Z25/Z125 - LocFindChameleonDevices: domain mask 0x%x.\n", domainMask ) );
 
+    scanP = (Z25_DOMAIN_SCAN_TS *)OSS_MemGet(NULL,
+                noDomains * sizeof(Z25_DOMAIN_SCAN_TS), &scanSize);
+    if( scanP == NULL ){
+        IZ25_PROF_RETURN(IZ25_PROF_FIND_CHAM, Z25_ERROR);
+    }
+    OSS_MemFill(NULL, scanSize, (char *)scanP, 0);
+
+    for( d=0, i=0; d<LZ25_MAX_DOMAINS; d++ ){
+        if( domainMask & ((u_int32)1 << d) ){
+            scanP[i].domain = (u_int8)d;
+            scanP[i].status = Z25_ERROR;
+            scanP[i].bridgeMapP = (Z25_PCI_BRIDGE_TS *)
+                calloc(Z25_MAX_PCI_BUS_SEARCH, sizeof(Z25_PCI_BRIDGE_TS));
+            scanP[i].pciDevicesP = (Z25_PCI_SCAN_TS *)
+                calloc(IZ25_MAX_PCI_SCAN, sizeof(Z25_PCI_SCAN_TS));
+            if( (scanP[i].bridgeMapP == NULL) ||
+                (scanP[i].pciDevicesP == NULL) ){
+                goto CLEANUP;
+            }
+            i++;
+        }
+    }
 
-    DBGWRT_1( (z25HdlP->dbgHdlP, "Z25/Z125 - LocFindChameleonDevices.\n" ) );
-    if( LocScanPciDevices(&pciDevicesP, &noPciDevices, pciDomain) == Z25_OK ) {
+    /*--------------------------------+
+     | scan the domains               |
+     +--------------------------------*/
+    parallel = (noDomains > 1) && G_Z25_ParallelDomainScan;
+    taskPriorityGet(taskIdSelf(), &prio);
+#ifdef Z25_PROFILE
+    scanMark = LocProfStart();
+#endif
 
-        DBGWRT_2( (z25HdlP->dbgHdlP,
-        		"Z25/Z125 - found %d considerable PCI devices.\n", noPciDevices ));
+    for( d=0; d<noDomains; d++ ){
+        if( parallel ){
+            scanP[d].doneSem = semBCreate(SEM_Q_FIFO, SEM_EMPTY);
+            if( (scanP[d].doneSem != NULL) &&
+                (taskSpawn("tZ25Scan", prio, 0, LZ25_SCAN_TASK_STACK,
+                           (FUNCPTR)LocScanDomain, (int)&scanP[d],
+                           0, 0, 0, 0, 0, 0, 0, 0, 0) != ERROR) ){
+                continue;
+            }
+            /* no task, scan here */
+            if( scanP[d].doneSem != NULL ){
+                semDelete(scanP[d].doneSem);
+                scanP[d].doneSem = NULL;
+            }
+        }
+        LocScanDomain(&scanP[d]);
+    }
 
-        for( i=0; i<noPciDevices; i++ ) {
-            while( G_deviceIdent[k] != IZ25_DEVICE_ID_END ) {
-                if( pciDevicesP->deviceId == G_deviceIdent[k] ){
+    for( d=0; d<noDomains; d++ ){
+        if( scanP[d].doneSem != NULL ){
+            semTake(scanP[d].doneSem, WAIT_FOREVER);
+            semDelete(scanP[d].doneSem);
+            scanP[d].doneSem = NULL;
+        }
+        G_Z25_PciCfgReads += scanP[d].cfgReads;
+    }
+#ifdef Z25_PROFILE
+    LocProfStop(&scanMark, IZ25_PROF_SCAN_PCI);
+#endif
 
-                    z25HdlP->pathInfo[index].pci.bus   = pciDevicesP->busNo;
-                    z25HdlP->pathInfo[index].pci.dev   = pciDevicesP->deviceNo;
-                    z25HdlP->pathInfo[index].pci.fct   = pciDevicesP->funcNo;
+    /*--------------------------------+
+     | merge the results              |
+     +--------------------------------*/
+    /* count matching devices to size the path table */
+    for( d=0; d<noDomains; d++ ){
+        if( scanP[d].status != Z25_OK ){
+            DBGWRT_2( (z25HdlP->dbgHdlP,
+                "Z25/Z125 - No considerable PCI devices in domain %d\n",
+                scanP[d].domain) );
+            continue;
+        }
 
-                    ++index;
+        DBGWRT_2( (z25HdlP->dbgHdlP,
+                "Z25/Z125 - found %d considerable PCI devices in domain %d.\n",
+                scanP[d].noPciDevices, scanP[d].domain ));
 
-                    DBGWRT_2( (z25HdlP->dbgHdlP,
-                        "Z25/Z125 - PCI device %d with vendor-id=0x%x and "
-                        "device-id=0x%x found at %d/%d/%d (bus/dev/func).\n",
-                        index, pciDevicesP->vendorId, G_deviceIdent[k],
-                        pciDevicesP->busNo,
-                        pciDevicesP->deviceNo,
-                        pciDevicesP->funcNo ) );
+        for( i=0; i < scanP[d].noPciDevices; i++ ) {
+            for( k=0; G_deviceIdent[k] != IZ25_DEVICE_ID_END; k++ ) {
+                if( scanP[d].pciDevicesP[i].deviceId == G_deviceIdent[k] ){
+                    noPaths++;
                 }
-                k++;
-            }
-            /* store current address of item */
-            addrFreeP = (u_int32 *)pciDevicesP;
-            pciDevicesP = (Z25_PCI_SCAN_TS *)pciDevicesP->nextP;
-            /* free list item */
-            free(addrFreeP);
-            k = 0;
-        }
-    } else {
-	    DBGWRT_ERR( (z25HdlP->dbgHdlP, "*** Z25/Z125 - No considerable PCI devices found\n") );
-	    /* KlocWork finding: free already malloc'ed elements, like above
-	     * (This scenario can occur if e.g. some list handles could be allocated,
-	     * then during search for Z25 devices we run out of memory).
-	     * In that case, LocScanPciDevices returned a nr. of PCI devices but not all.
-	     * We iterate trough the list from start element to that number (or as long as there
-	     * are ->nextP elements) and free them. */
-	    for( i=0; (i < noPciDevices) && (pciDevicesP != NULL); i++ ) {
-		    addrFreeP = (u_int32 *)pciDevicesP;
-		    pciDevicesP = (Z25_PCI_SCAN_TS *)pciDevicesP->nextP;
-		    /* free list item */
-		    free(addrFreeP);
-		    addrFreeP = NULL;
-	    }
-		return Z25_ERROR;
+            }
+        }
     }
 
-    z25HdlP->noPciPaths = index;
-    /* KlocWork finding: assure that index isn't larger than IZ25_MAX_PCI_DEV */
-    if ( index >= IZ25_MAX_PCI_DEV ) {
-            DBGWRT_ERR( (z25HdlP->dbgHdlP, "*** Z25/Z125 - internal error (too many devices ?)\n") );
-            return Z25_ERROR;
+    if( noPaths == 0 ){
+        DBGWRT_ERR( (z25HdlP->dbgHdlP, "*** Z25/Z125 - No Chameleon device matched\n") );
+        goto CLEANUP;
     }
 
-    /* store found devices in Z25 handle */
-    for( i=0; i<index; i++){
-        if( LocGetDevicePath(hdlP, z25HdlP->pathInfo[i].pci.path,
-        		&z25HdlP->pathInfo[i].pci.pathLen, i) != Z25_OK ){
-            DBGWRT_ERR( (z25HdlP->dbgHdlP,
-                "*** Z25/Z125 - No device path found for device %d.\n", i) );
-            return Z25_ERROR;
-        }
+    z25HdlP->pathInfo = (Z25_PATH_TS *)
+        OSS_MemGet(NULL, noPaths * sizeof(Z25_PATH_TS), &gotSize);
+    if( z25HdlP->pathInfo == NULL ){
+        DBGWRT_ERR( (z25HdlP->dbgHdlP,
+            "*** Z25/Z125 - Could not allocate path table\n") );
+        goto CLEANUP;
     }
+    OSS_MemFill(NULL, gotSize, (char*)z25HdlP->pathInfo, 0);
+    z25HdlP->maxPciPaths = noPaths;
 
-    return Z25_OK;
-} /* LocFindChameleonDevices*/
+    for( d=0; d<noDomains; d++ ){
+        if( scanP[d].status != Z25_OK ){
+            continue;
+        }
 
-/**********************************************************************/
-/** Routine to initialize the found UART units
- *
- *  This routine performs the basic UART initializations. It stores the
- *  address and enumerates the channels automatically.
- *
- *  \param hdlP         Z25 handle returned by Z25_Init
- *  \param address      unit address
- *  \param irq          unit interrupt number
- *  \param uartCore     uart core identifier
- *
+        for( i=0; i<scanP[d].noPciDevices; i++ ) {
+            pciDevP = &scanP[d].pciDevicesP[i];
+
+            for( k=0; G_deviceIdent[k] != IZ25_DEVICE_ID_END; k++ ) {
+                if( (pciDevP->deviceId != G_deviceIdent[k]) ||
+                    (index >= noPaths) ){
+                    continue;
+                }
+
+                z25HdlP->pathInfo[index].pci.bus   =
+                    OSS_MERGE_BUS_DOMAIN(pciDevP->busNo, scanP[d].domain);
+                z25HdlP->pathInfo[index].pci.dev   = pciDevP->deviceNo;
+                z25HdlP->pathInfo[index].pci.fct   = pciDevP->funcNo;
+#ifdef Z25_USE_VXBPCI_FUNCS
+                z25HdlP->pathInfo[index].pci.vxbDevID =
+                    sysGetPciCtrlID(scanP[d].domain);
+#else
+                z25HdlP->pathInfo[index].pci.vxbDevID = G_Z25_vxbDevID;
+#endif
+                z25HdlP->noPciPaths = index + 1;
+
+                DBGWRT_2( (z25HdlP->dbgHdlP,
+                    "Z25/Z125 - PCI device %d with vendor-id=0x%x and "
+                    "device-id=0x%x found at %d:%d/%d/%d (dom:bus/dev/func).\n",
+                    index + 1, pciDevP->vendorId, G_deviceIdent[k],
+                    scanP[d].domain,
+                    pciDevP->busNo,
+                    pciDevP->deviceNo,
+                    pciDevP->funcNo ) );
+
+                /* PCI path from the bridge map of the domain */
+                if( LocGetDevicePath(hdlP, scanP[d].bridgeMapP,
+                        z25HdlP->pathInfo[index].pci.path,
+                        &z25HdlP->pathInfo[index].pci.pathLen,
+                        (u_int16)index) != Z25_OK ){
+                    DBGWRT_ERR( (z25HdlP->dbgHdlP,
+                        "*** Z25/Z125 - No device path found for device %d.\n",
+                        index) );
+                    goto CLEANUP;
+                }
+
+                ++index;
+            }
+        }
+    }
+
+#ifdef DBG
+    DBGWRT_2( (z25HdlP->dbgHdlP,
+        "Z25/Z125 - PCI discovery used %d config cycles\n",
+        G_Z25_PciCfgReads - cfgReads) );
+#endif
+
+    retVal = Z25_OK;
+
+CLEANUP:
+    for( d=0; d<noDomains; d++ ){
+        free(scanP[d].bridgeMapP);
+        free(scanP[d].pciDevicesP);
+    }
+    OSS_MemFree(NULL, (void *)scanP, scanSize);
+
+    IZ25_PROF_RETURN(IZ25_PROF_FIND_CHAM, retVal);
+} /* LocFindChameleonDevices*/
+
+/**********************************************************************/
+/** Routine to parse the Chameleon table of a PCI path
+ *
+ *  This routine reads the Chameleon table of the FPGA once and stores
+ *  all 16Z025/16Z125 and 16Z057 units in the index of the path, grouped
+ *  by module id. Later calls return at once.
+ *
+ *  \param hdlP         Z25 handle returned by Z25_Init
+ *  \param pathIndex    index of PCI path in its array
+ *
  *  \return Z25_OK or Z25_ERROR
  */
-LOCAL STATUS LocInitUartUnit(Z25_HDL *hdlP,
-                             u_int32 address,
-                             u_int8 irq,
-                             u_int16 uartCore){
-    u_int8 i;               /* loop index */
-    u_int8 uartsExist = 0;  /* existing UART channels */
-    u_int16 loopIndex = 0;
-    Z25_DEV_TS *z25HdlP;  /* Z25 resources */
-    Z25_TY_CO_DEV_TS *tmpQuadUartP;    /* UART resources */
-    HDL_16Z25 *tmpHdlP;    /* 16Z025 handle */
+LOCAL STATUS LocParseChamTable(Z25_HDL *hdlP, u_int16 pathIndex){
+    Z25_DEV_TS *z25HdlP;                /* Z25 resources */
+    Z25_PATH_TS *pathP;                 /* PCI path */
+    CHAM_FUNCTBL        chamFctTable;   /* Chameleon function table */
+    CHAMELEONV2_HANDLE *chamHdl;        /* Chameleon handle */
+    CHAMELEONV2_UNIT    chamInfo;       /* Chameleon unit information */
+    u_int16 devId[IZ25_NO_MODID];       /* Chameleon device ids */
+    Z25_CHAM_UNIT_TS *tmpP = NULL;      /* units in table order */
+    u_int8 *modP = NULL;                /* module id index of units */
+    Z25_CHAM_UNIT_TS *unitP = NULL;     /* units grouped by module id */
+    u_int16 modCnt[IZ25_NO_MODID];      /* units per module id */
+    u_int16 noTmp = 0;
+    u_int16 maxTmp = 0;
+    u_int16 next[IZ25_NO_MODID];        /* next free entry per module id */
+    u_int32 gotSize = 0;
+    u_int32 idx;                        /* Chameleon table index */
+    int32 chamRet;                      /* UnitIdent result */
+    u_int16 i, k;
+    STATUS retVal = Z25_ERROR;
+
+    if( (z25HdlP = hdlP) == NULL ){
+        return Z25_ERROR;
+    }
+
+    if( pathIndex >= z25HdlP->noPciPaths ){
+        return Z25_ERROR;
+    }
+
+    pathP = &z25HdlP->pathInfo[pathIndex];
+    if( pathP->chamIdx.parsed ){
+        return Z25_OK;
+    }
+
+    if( CHAM_INIT(&chamFctTable) != CHAMELEON_OK ){
+        DBGWRT_ERR( (z25HdlP->dbgHdlP,
+            "*** Z25/Z125 - Chameleon V2 initialization failed.\n") );
+        return Z25_ERROR;
+    }
+
+    /* when the MDIS project for the CPU on which this driver runs
+     * is compiled with OSS_VXBUS_SUPPORT then the PCI domain which should be
+     * merged into the upper 16bit of bus nr. are evaluated as the PCI domain
+     * */
+    if( chamFctTable.InitPci( NULL,
+                              pathP->pci.bus,
+                              pathP->pci.dev,
+                              pathP->pci.fct,
+                              &chamHdl) != CHAMELEON_OK ){
+        DBGWRT_ERR( (z25HdlP->dbgHdlP,
+            "*** Z25/Z125 - Chameleon V2 PCI initialization failed.\n") );
+        return Z25_ERROR;
+    }
+
+    for( k=0; k<IZ25_NO_MODID; k++ ){
+        devId[k]  = CHAM_ModCodeToDevId( G_modId[k] );
+        modCnt[k] = 0;
+    }
+
+    /*
+     * single pass over the table, all module ids at once;
+     * bridge, cpu and bar entries are skipped, any other result
+     * (table end or error) stops the pass
+     */
+    for( idx=0; ; idx++ ){
+        chamRet = chamFctTable.UnitIdent(chamHdl, idx, &chamInfo);
+        if( (chamRet == CHAMELEONV2_BRIDGE_FOUND) ||
+            (chamRet == CHAMELEONV2_CPU_FOUND) ||
+            (chamRet == CHAMELEONV2_BAR_FOUND) ){
+            continue;
+        }
+        if( chamRet != CHAMELEONV2_UNIT_FOUND ){
+            if( chamRet != CHAMELEONV2_NO_MORE_ENTRIES ){
+                DBGWRT_ERR( (z25HdlP->dbgHdlP,
+                    "*** Z25/Z125 - Chameleon table error 0x%x at entry %d\n",
+                    chamRet, idx) );
+            }
+            break;
+        }
+        for( k=0; k<IZ25_NO_MODID; k++ ){
+            if( chamInfo.devId == devId[k] ){
+                break;
+            }
+        }
+        if( k == IZ25_NO_MODID ){
+            continue;
+        }
+
+        if( noTmp == maxTmp ){
+            Z25_CHAM_UNIT_TS *newP;
+            u_int8 *newModP;
+
+            newP = (Z25_CHAM_UNIT_TS *)OSS_MemGet(NULL,
+                    (maxTmp + IZ25_CHAM_IDX_STEP) * sizeof(Z25_CHAM_UNIT_TS),
+                    &gotSize);
+            newModP = (u_int8 *)OSS_MemGet(NULL,
+                    maxTmp + IZ25_CHAM_IDX_STEP, &gotSize);
+            if( (newP == NULL) || (newModP == NULL) ){
+                if( newP != NULL ){
+                    OSS_MemFree(NULL, (void *)newP,
+                        (maxTmp + IZ25_CHAM_IDX_STEP) * sizeof(Z25_CHAM_UNIT_TS));
+                }
+                if( newModP != NULL ){
+                    OSS_MemFree(NULL, (void *)newModP,
+                                maxTmp + IZ25_CHAM_IDX_STEP);
+                }
+                goto CLEANUP;
+            }
+            if( noTmp > 0 ){
+                memcpy(newP, tmpP, noTmp * sizeof(Z25_CHAM_UNIT_TS));
+                memcpy(newModP, modP, noTmp);
+                OSS_MemFree(NULL, (void *)tmpP,
+                            maxTmp * sizeof(Z25_CHAM_UNIT_TS));
+                OSS_MemFree(NULL, (void *)modP, maxTmp);
+            }
+            tmpP = newP;
+            modP = newModP;
+            maxTmp += IZ25_CHAM_IDX_STEP;
+        }
+
+        tmpP[noTmp].addr      = (u_int32)chamInfo.addr;
+        tmpP[noTmp].interrupt = chamInfo.interrupt;
+        tmpP[noTmp].instance  = chamInfo.instance;
+        modP[noTmp] = (u_int8)k;
+        modCnt[k]++;
+        noTmp++;
+    }
+
+    /* group by module id, table order is kept within a group */
+    if( noTmp > 0 ){
+        unitP = (Z25_CHAM_UNIT_TS *)OSS_MemGet(NULL,
+                    noTmp * sizeof(Z25_CHAM_UNIT_TS), &gotSize);
+        if( unitP == NULL ){
+            goto CLEANUP;
+        }
+    }
+
+    pathP->chamIdx.modStart[0] = 0;
+    for( k=0; k<IZ25_NO_MODID; k++ ){
+        pathP->chamIdx.modStart[k+1] = pathP->chamIdx.modStart[k] + modCnt[k];
+        next[k] = pathP->chamIdx.modStart[k];
+    }
+    for( i=0; i<noTmp; i++ ){
+        unitP[next[modP[i]]++] = tmpP[i];
+    }
+
+    pathP->chamIdx.unitP   = unitP;
+    pathP->chamIdx.noUnits = noTmp;
+    pathP->chamIdx.parsed  = TRUE;
+
+    DBGWRT_2( (z25HdlP->dbgHdlP,
+        "Z25/Z125 - path %d: %d of %d Chameleon units are uarts\n",
+        pathIndex, noTmp, idx) );
+
+    retVal = Z25_OK;
+
+CLEANUP:
+    if( tmpP != NULL ){
+        OSS_MemFree(NULL, (void *)tmpP, maxTmp * sizeof(Z25_CHAM_UNIT_TS));
+        OSS_MemFree(NULL, (void *)modP, maxTmp);
+    }
+    chamFctTable.Term(&chamHdl);
+
+    return retVal;
+}/* LocParseChamTable */
+
+/**********************************************************************/
+/** Routine to get a unit from the Chameleon index of a PCI path
+ *
+ *  \param pathP        PCI path, parsed by LocParseChamTable
+ *  \param modIdx       index of module id in G_modId
+ *  \param instance     n-th unit of this module id
+ *
+ *  \return unit or NULL if not present
+ */
+LOCAL Z25_CHAM_UNIT_TS *LocChamUnitGet(Z25_PATH_TS *pathP,
+                                       u_int16 modIdx,
+                                       u_int16 instance){
+    u_int16 entry;
+
+    if( !pathP->chamIdx.parsed || (modIdx >= IZ25_NO_MODID) ){
+        return NULL;
+    }
+
+    entry = pathP->chamIdx.modStart[modIdx] + instance;
+    if( entry >= pathP->chamIdx.modStart[modIdx+1] ){
+        return NULL;
+    }
+
+    return &pathP->chamIdx.unitP[entry];
+}/* LocChamUnitGet */
+
+/**********************************************************************/
+/** Routine to free the Chameleon index of a PCI path
+ *
+ *  \param pathP        PCI path
+ *
+ *  \return no return value
+ */
+LOCAL void LocFreeChamTable(Z25_PATH_TS *pathP){
+    if( pathP->chamIdx.unitP != NULL ){
+        OSS_MemFree(NULL, (void *)pathP->chamIdx.unitP,
+                    pathP->chamIdx.noUnits * sizeof(Z25_CHAM_UNIT_TS));
+    }
+    OSS_MemFill(NULL, sizeof(Z25_CHAM_IDX_TS), (char *)&pathP->chamIdx, 0);
+}/* LocFreeChamTable */
+
+/**********************************************************************/
+/** Routine to build the Chameleon index of a path from a static map
+ *
+ *  This routine fills the index of the path with the units of a static
+ *  device map entry instead of reading the Chameleon table. The unit
+ *  addresses are the PCI BAR addresses plus the given offsets.
+ *
+ *  \param hdlP         Z25 handle returned by Z25_Init
+ *  \param pathIndex    index of PCI path in its array
+ *  \param sdP          static device map entry of the path
+ *
+ *  \return Z25_OK or Z25_ERROR
+ */
+LOCAL STATUS LocStaticChamTable(Z25_HDL *hdlP,
+                                u_int16 pathIndex,
+                                const Z25_STATIC_DEV *sdP){
+    Z25_DEV_TS *z25HdlP;                /* Z25 resources */
+    Z25_PATH_TS *pathP;                 /* PCI path */
+    const Z25_STATIC_UNIT *suP;         /* static unit */
+    Z25_CHAM_UNIT_TS *unitP = NULL;     /* units grouped by module id */
+    void *barAddr[IZ25_PCI_NO_BAR];     /* resolved BAR addresses */
+    u_int16 modCnt[IZ25_NO_MODID];      /* units per module id */
+    u_int16 next[IZ25_NO_MODID];        /* next free entry per module id */
+    u_int32 gotSize = 0;
+    u_int16 i, k;
+
+    if( (z25HdlP = hdlP) == NULL ){
+        return Z25_ERROR;
+    }
+
+    pathP = &z25HdlP->pathInfo[pathIndex];
+
+    for( k=0; k<IZ25_NO_MODID; k++ ){
+        modCnt[k] = 0;
+    }
+    for( k=0; k<IZ25_PCI_NO_BAR; k++ ){
+        barAddr[k] = NULL;
+    }
+
+    /* check the entries, count them per module id */
+    for( i=0; i<sdP->noUnits; i++ ){
+        suP = &sdP->unitP[i];
+
+        for( k=0; k<IZ25_NO_MODID; k++ ){
+            if( suP->modCode == G_modId[k] ){
+                break;
+            }
+        }
+        if( (k == IZ25_NO_MODID) || (suP->bar >= IZ25_PCI_NO_BAR) ){
+            DBGWRT_ERR( (z25HdlP->dbgHdlP,
+                "*** Z25/Z125 - static map: invalid unit %d (modCode=0x%x, bar=%d)\n",
+                i, suP->modCode, suP->bar) );
+            return Z25_ERROR;
+        }
+        modCnt[k]++;
+
+        if( (barAddr[suP->bar] == NULL) &&
+            (OSS_BusToPhysAddr(NULL, OSS_BUSTYPE_PCI, &barAddr[suP->bar],
+                               pathP->pci.bus, pathP->pci.dev,
+                               pathP->pci.fct, (u_int32)suP->bar) != 0) ){
+            DBGWRT_ERR( (z25HdlP->dbgHdlP,
+                "*** Z25/Z125 - static map: BAR%d of path %d not mapped\n",
+                suP->bar, pathIndex) );
+            return Z25_ERROR;
+        }
+    }
+
+    if( sdP->noUnits > 0 ){
+        unitP = (Z25_CHAM_UNIT_TS *)OSS_MemGet(NULL,
+                    sdP->noUnits * sizeof(Z25_CHAM_UNIT_TS), &gotSize);
+        if( unitP == NULL ){
+            return Z25_ERROR;
+        }
+    }
+
+    pathP->chamIdx.modStart[0] = 0;
+    for( k=0; k<IZ25_NO_MODID; k++ ){
+        pathP->chamIdx.modStart[k+1] = pathP->chamIdx.modStart[k] + modCnt[k];
+        next[k] = pathP->chamIdx.modStart[k];
+    }
+
+    /* group by module id, map order is kept within a group */
+    for( i=0; i<sdP->noUnits; i++ ){
+        suP = &sdP->unitP[i];
+        for( k=0; suP->modCode != G_modId[k]; k++ )
+            ;
+
+        unitP[next[k]].addr      = (u_int32)barAddr[suP->bar] + suP->offset;
+        unitP[next[k]].interrupt = suP->interrupt;
+        unitP[next[k]].instance  = next[k] - pathP->chamIdx.modStart[k];
+        next[k]++;
+    }
+
+    pathP->chamIdx.unitP   = unitP;
+    pathP->chamIdx.noUnits = sdP->noUnits;
+    pathP->chamIdx.parsed  = TRUE;
+
+    DBGWRT_2( (z25HdlP->dbgHdlP,
+        "Z25/Z125 - path %d: %d uart units from static map\n",
+        pathIndex, sdP->noUnits) );
+
+    return Z25_OK;
+}/* LocStaticChamTable */
+
+/**********************************************************************/
+/** Routine to look up a PCI path in the path table
+ *
+ *  \param hdlP         Z25 handle returned by Z25_Init
+ *  \param bus          PCI bus (with merged domain)
+ *  \param dev          PCI device
+ *  \param fct          PCI function
+ *  \param pathIndexP   index of path
+ *
+ *  \return Z25_OK or Z25_ERROR if the location is not in the table
+ */
+LOCAL STATUS LocFindPath(Z25_HDL *hdlP,
+                         u_int32 bus,
+                         u_int16 dev,
+                         u_int16 fct,
+                         u_int16 *pathIndexP){
+    Z25_DEV_TS *z25HdlP;                /* Z25 resources */
+    u_int16 i;
+
+    if( (z25HdlP = hdlP) == NULL ){
+        return Z25_ERROR;
+    }
+
+    for( i=0; i<z25HdlP->noPciPaths; i++ ){
+        if( (z25HdlP->pathInfo[i].pci.bus == bus) &&
+            (z25HdlP->pathInfo[i].pci.dev == dev) &&
+            (z25HdlP->pathInfo[i].pci.fct == fct) ){
+            *pathIndexP = i;
+            return Z25_OK;
+        }
+    }
+
+    return Z25_ERROR;
+}/* LocFindPath */
+
+/**********************************************************************/
+/** Routine to add a PCI path to the path table
+ *
+ *  This routine returns the index of the path with the given PCI location.
+ *  If the location is not in the table yet, the table is grown by one
+ *  entry. Existing entries keep their index.
+ *
+ *  \param hdlP         Z25 handle returned by Z25_Init
+ *  \param bus          PCI bus (with merged domain)
+ *  \param dev          PCI device
+ *  \param fct          PCI function
+ *  \param pathIndexP   index of path
+ *
+ *  \return Z25_OK or Z25_ERROR
+ */
+LOCAL STATUS LocAddPath(Z25_HDL *hdlP,
+                        u_int32 bus,
+                        u_int16 dev,
+                        u_int16 fct,
+                        u_int16 *pathIndexP){
+    Z25_DEV_TS *z25HdlP;                /* Z25 resources */
+    Z25_PATH_TS *pathP;                 /* new path table */
+    u_int32 gotSize = 0;
+    u_int16 i;
+
+    if( (z25HdlP = hdlP) == NULL ){
+        return Z25_ERROR;
+    }
+
+    if( LocFindPath(z25HdlP, bus, dev, fct, pathIndexP) == Z25_OK ){
+        return Z25_OK;
+    }
+
+    if( z25HdlP->noPciPaths == z25HdlP->maxPciPaths ){
+        pathP = (Z25_PATH_TS *)OSS_MemGet(NULL,
+                    (z25HdlP->maxPciPaths + 1) * sizeof(Z25_PATH_TS), &gotSize);
+        if( pathP == NULL ){
+            return Z25_ERROR;
+        }
+        OSS_MemFill(NULL, gotSize, (char *)pathP, 0);
+
+        if( z25HdlP->pathInfo != NULL ){
+            memcpy(pathP, z25HdlP->pathInfo,
+                   z25HdlP->noPciPaths * sizeof(Z25_PATH_TS));
+            OSS_MemFree(NULL, (void *)z25HdlP->pathInfo,
+                        z25HdlP->maxPciPaths * sizeof(Z25_PATH_TS));
+        }
+        z25HdlP->pathInfo = pathP;
+        z25HdlP->maxPciPaths++;
+    }
+
+    i = z25HdlP->noPciPaths++;
+    z25HdlP->pathInfo[i].pci.bus = bus;
+    z25HdlP->pathInfo[i].pci.dev = dev;
+    z25HdlP->pathInfo[i].pci.fct = fct;
+    *pathIndexP = i;
+
+    return Z25_OK;
+}/* LocAddPath */
+
+/**********************************************************************/
+/** Routine to count the UART units of all found Chameleon devices
+ *
+ *  This routine parses the Chameleon tables of all registered PCI paths
+ *  and counts the 16Z025/16Z125 and 16Z057 units. The result is used to
+ *  size the unit tables in Z25_InitDriver. The parsed tables are kept
+ *  for Z25_FindUartUnits.
+ *
+ *  \param hdlP         Z25 handle returned by Z25_Init
+ *
+ *  \return number of UART units
+ */
+LOCAL u_int16 LocCountUartUnits(Z25_HDL *hdlP){
+    Z25_DEV_TS *z25HdlP;                /* Z25 resources */
+    u_int16 i;                          /* path index */
+    u_int16 noUnits = 0;                /* units found */
+
+    if( (z25HdlP = hdlP) == NULL ){
+        return 0;
+    }
+
+    for( i=0; i<z25HdlP->noPciPaths; i++ ){
+        if( LocParseChamTable(z25HdlP, i) == Z25_OK ){
+            noUnits += z25HdlP->pathInfo[i].chamIdx.noUnits;
+        }
+    }
+
+    DBGWRT_2( (z25HdlP->dbgHdlP,
+        "Z25/Z125 - %d uart unit(s) counted on %d PCI path(s)\n",
+        noUnits, z25HdlP->noPciPaths) );
+
+    return noUnits;
+}/* LocCountUartUnits */
+
+/**********************************************************************/
+/** Routine to allocate or grow the unit tables
+ *
+ *  This routine (re)allocates quadUart, isrUnitP and driverNumber for
+ *  maxUnits units. Existing entries are moved to the new tables. Since
+ *  created channels are referenced by the I/O system and the ISR, the
+ *  tables can only be grown as long as no channel has been created.
+ *
+ *  \param hdlP         Z25 handle returned by Z25_Init
+ *  \param maxUnits     new number of units
+ *
+ *  \return Z25_OK or Z25_ERROR
+ */
+LOCAL STATUS LocAllocUnitTables(Z25_HDL *hdlP, u_int16 maxUnits){
+    Z25_DEV_TS *z25HdlP;                /* Z25 resources */
+    Z25_TY_CO_DEV_TS (*quadUartP)[IZ25_MAX_UARTS_PER_DEV] = NULL;
+    Z25_ISR_UNIT_TS **isrUnitP = NULL;
+    int16 *driverNumberP = NULL;
+    u_int32 gotSize = 0;
+    u_int16 i, j;
+
+    if( (z25HdlP = hdlP) == NULL ){
+        return Z25_ERROR;
+    }
+
+    if( maxUnits <= z25HdlP->maxUnits ){
+        return Z25_OK;
+    }
+
+    /* moving created channels is not possible */
+    for( i=0; i<z25HdlP->no16Z25Dev; i++ ){
+        if( z25HdlP->isrUnitP[i] != NULL && z25HdlP->isrUnitP[i]->connected ){
+            goto CLEANUP;
+        }
+        for( j=0; j<IZ25_MAX_UARTS_PER_DEV; j++ ){
+            if( z25HdlP->quadUart[i][j].created ){
+                goto CLEANUP;
+            }
+        }
+    }
+
+    quadUartP = OSS_MemGet(NULL, maxUnits * sizeof(*quadUartP), &gotSize);
+    if( quadUartP == NULL ){
+        goto CLEANUP;
+    }
+    OSS_MemFill(NULL, gotSize, (char*)quadUartP, 0);
+
+    isrUnitP = OSS_MemGet(NULL, maxUnits * sizeof(*isrUnitP), &gotSize);
+    if( isrUnitP == NULL ){
+        goto CLEANUP;
+    }
+    OSS_MemFill(NULL, gotSize, (char*)isrUnitP, 0);
+
+    driverNumberP = OSS_MemGet(NULL, maxUnits * sizeof(*driverNumberP), &gotSize);
+    if( driverNumberP == NULL ){
+        goto CLEANUP;
+    }
+    OSS_MemFill(NULL, gotSize, (char*)driverNumberP, 0);
+
+    /* move already initialized units */
+    if( z25HdlP->maxUnits > 0 ){
+        bcopy((char*)z25HdlP->quadUart, (char*)quadUartP,
+              z25HdlP->maxUnits * sizeof(*quadUartP));
+        bcopy((char*)z25HdlP->isrUnitP, (char*)isrUnitP,
+              z25HdlP->maxUnits * sizeof(*isrUnitP));
+        bcopy((char*)z25HdlP->driverNumber, (char*)driverNumberP,
+              z25HdlP->maxUnits * sizeof(*driverNumberP));
+
+        for( i=0; i<z25HdlP->no16Z25Dev; i++ ){
+            for( j=0; j<IZ25_MAX_UARTS_PER_DEV; j++ ){
+                if( quadUartP[i][j].unitHdlP != NULL ){
+                    quadUartP[i][j].unitHdlP = &quadUartP[i][j].uartUnit;
+                }
+                if( isrUnitP[i] != NULL ){
+                    isrUnitP[i]->chan[j].chanP = &quadUartP[i][j];
+                }
+            }
+        }
+
+        OSS_MemFree(NULL, (void*)z25HdlP->quadUart,
+                    z25HdlP->maxUnits * sizeof(*quadUartP));
+        OSS_MemFree(NULL, (void*)z25HdlP->isrUnitP,
+                    z25HdlP->maxUnits * sizeof(*isrUnitP));
+        OSS_MemFree(NULL, (void*)z25HdlP->driverNumber,
+                    z25HdlP->maxUnits * sizeof(*driverNumberP));
+    }
+
+    z25HdlP->quadUart     = quadUartP;
+    z25HdlP->isrUnitP     = isrUnitP;
+    z25HdlP->driverNumber = driverNumberP;
+    z25HdlP->maxUnits     = maxUnits;
+
+    DBGWRT_2( (z25HdlP->dbgHdlP,
+        "Z25/Z125 - unit tables sized for %d unit(s)\n", maxUnits) );
+
+    return Z25_OK;
+
+CLEANUP:
+    DBGWRT_ERR( (z25HdlP->dbgHdlP,
+        "*** Z25/Z125 - Could not size unit tables for %d unit(s)\n", maxUnits) );
+    if( quadUartP != NULL ){
+        OSS_MemFree(NULL, (void*)quadUartP, maxUnits * sizeof(*quadUartP));
+    }
+    if( isrUnitP != NULL ){
+        OSS_MemFree(NULL, (void*)isrUnitP, maxUnits * sizeof(*isrUnitP));
+    }
+    return Z25_ERROR;
+}/* LocAllocUnitTables */
+
+/**********************************************************************/
+/** Routine to initialize the found UART units
+ *
+ *  This routine performs the basic UART initializations. It stores the
+ *  address and enumerates the channels automatically.
+ *
+ *  \param hdlP         Z25 handle returned by Z25_Init
+ *  \param address      unit address
+ *  \param irq          unit interrupt number
+ *  \param uartCore     uart core identifier
+ *
+ *  \return Z25_OK or Z25_ERROR
+ */
+LOCAL STATUS LocInitUartUnit(Z25_HDL *hdlP,
+                             u_int32 address,
+                             u_int8 irq,
+                             u_int16 uartCore){
+    u_int8 i;               /* loop index */
+    u_int8 uartsExist = 0;  /* existing UART channels */
+    u_int16 loopIndex = 0;
+    Z25_DEV_TS *z25HdlP;  /* Z25 resources */
+    Z25_TY_CO_DEV_TS *tmpQuadUartP;    /* UART resources */
+    Z25_ISR_UNIT_TS *isrP;  /* ISR descriptor of unit */
+
+    if( hdlP == NULL ){
+        return Z25_ERROR;
+    }
+    else {
+        z25HdlP = hdlP;
+    }
+
+    /* Z125 uart detected */
+    if( uartCore == IZ25_MODID_2 ){
+        loopIndex = IZ25_MIN_UARTS_PER_DEV;
+         DBGWRT_1((z25HdlP->dbgHdlP,
+        "Z25/Z125 - module id 0x%x / Z125 uart core detected !\n",
+            uartCore));
+    }
+    else {
+        loopIndex = Z25_MAX_UARTS_PER_DEV;
+        DBGWRT_1((z25HdlP->dbgHdlP,
+        "Z25/Z125 - module id 0x%x / Z25 uart core detected !\n",
+            uartCore));
+
+        uartsExist = MZ25_UARTS_EXISTING((u_int32)(address));
+
+        if( uartsExist == 0 ){
+            DBGWRT_ERR((z25HdlP->dbgHdlP,
+            "*** Z25/Z125 - No UART channel detected ! \n"));
+            return Z25_ERROR;
+        }
+    }/* end if */
+
+    if( loopIndex == 0 ){
+        DBGWRT_ERR((z25HdlP->dbgHdlP,
+        "*** Z25/Z125 - No UART channel detected ! \n"));
+        return Z25_ERROR;
+    }/* end if */
+
+    /* more units than counted at Z25_InitDriver? */
+    if( z25HdlP->no16Z25Dev >= z25HdlP->maxUnits ){
+        if( LocAllocUnitTables(z25HdlP,
+                z25HdlP->maxUnits + IZ25_UNIT_TABLE_STEP) != Z25_OK ){
+            return Z25_ERROR;
+        }
+    }
+
+    /* ISR descriptor, cache line aligned */
+    if( (isrP = (Z25_ISR_UNIT_TS *)
+         memalign(_CACHE_ALIGN_SIZE, IZ25_ISR_UNIT_SIZE)) == NULL ){
+        DBGWRT_ERR((z25HdlP->dbgHdlP,
+        "*** Z25/Z125 - Could not allocate ISR descriptor\n"));
+        return Z25_ERROR;
+    }
+    bzero((char*)isrP, IZ25_ISR_UNIT_SIZE);
+    if( (isrP->connectSem = semMCreate( SEM_Q_PRIORITY |
+                                        SEM_DELETE_SAFE |
+                                        SEM_INVERSION_SAFE )) == NULL ){
+        DBGWRT_ERR((z25HdlP->dbgHdlP,
+        "*** Z25/Z125 - Could not create unit mutex\n"));
+        free(isrP);
+        return Z25_ERROR;
+    }
+    isrP->baseAddr = address;
+    isrP->uartCore = uartCore;
+    isrP->noChan   = (u_int8)loopIndex;
+    z25HdlP->isrUnitP[z25HdlP->no16Z25Dev] = isrP;
+
+    for( i=0; i<loopIndex; i++ ){
+        u_int8 uartMask = 0;
+
+        /* set pointer to UART channel */
+        tmpQuadUartP =
+            &z25HdlP->quadUart[z25HdlP->no16Z25Dev][i];
+
+        tmpQuadUartP->baseAddr = address;
+
+        uartMask = 1 << i;
+
+        /* check if UART exists */
+        if( ((uartsExist&uartMask) != uartMask) &&
+            (uartCore != IZ25_MODID_2) ){
+            tmpQuadUartP->addr = 0;
+        }
+        else {/* fill channel structure */
+            if( uartCore == IZ25_MODID_2 ){
+                tmpQuadUartP->addr = (u_int32)address;
+            }
+            else {
+                tmpQuadUartP->addr = (u_int32)(address + i*IZ25_CHANNEL_OFFSET);
+            } /* end if */
+            tmpQuadUartP->channel = z25HdlP->noUarts++;
+            tmpQuadUartP->dbgHdlP = z25HdlP->dbgHdlP;
+
+            if( (tmpQuadUartP->chanSem = semMCreate( SEM_Q_PRIORITY |
+                                                     SEM_DELETE_SAFE |
+                                                     SEM_INVERSION_SAFE ))
+                == NULL ){
+                DBGWRT_ERR((z25HdlP->dbgHdlP,
+                "*** Z25/Z125 - Could not create channel mutex\n"));
+                return Z25_ERROR;
+            }
+
+            /* yes, init embedded MZ25 handle */
+            if( MZ25_InitUnit
+                (&tmpQuadUartP->uartUnit,
+                tmpQuadUartP->addr ) == 0 ){   /* store 16Z25 handle to channel structure */
+                tmpQuadUartP->unitHdlP = &tmpQuadUartP->uartUnit;
+            }
+            else {
+                DBGWRT_ERR((z25HdlP->dbgHdlP,
+                "*** Z25/Z125 - Could not init 16Z25 handle\n"));
+                return Z25_ERROR;
+            }
+        }
+        isrP->chan[i].addr  = tmpQuadUartP->addr;
+        isrP->chan[i].chanP = tmpQuadUartP;
+        /* register interrupt */
+        tmpQuadUartP->irq = irq;
+        tmpQuadUartP->irqvec = irq + z25HdlP->irqFct.extIrqBase;
+        tmpQuadUartP->uartCore = uartCore;
+    }
+
+    /* increment unit number */
+    ++z25HdlP->no16Z25Dev;
+
+    return Z25_OK;
+}/* LocInitUartUnit */
+
+/**********************************************************************/
+/** Routine to Create a channel
+ *
+ *  \param chanP            channel structure
+ *  \param name             device name (used by tyLib)
+ *  \param mode             device mode (used by tyLib)
+ *
+ *  \return address to channel structure
+ */
+LOCAL int LocCreate( Z25_TY_CO_DEV_TS *chanP,
+                   int8 *name,
+                   int mode )
+{
+    return (int)chanP;
+}/* LocCreate */
+
+/**********************************************************************/
+/** Routine to open a channel
+ *
+ *  This routine is used by the tyLib to open a UART channel using the
+ *  VxWorks function 'open(...)'. A member of a bonded device can not be
+ *  opened directly (errno EBUSY).
+ *
+ *  \param chanP            channel structure
+ *  \param name             device name (used by tyLib)
+ *  \param mode             device mode (used by tyLib)
+ *
+ *  \return address to channel structure
+ */
+LOCAL int LocOpen( Z25_TY_CO_DEV_TS *chanP )
+{
+	if( (chanP != NULL) && (chanP->bondP != NULL) ){
+		errnoSet(EBUSY);
+		return(Z25_ERROR);
+	}
+
+	return LocChanOpen(chanP);
+}/* LocOpen */
+
+/**********************************************************************/
+/** Routine to open a channel for the i/o system or a bonded device
+ *
+ *  \param chanP            channel structure
+ *
+ *  \return address to channel structure
+ */
+LOCAL int LocChanOpen( Z25_TY_CO_DEV_TS *chanP )
+{
+	if (chanP != NULL) {
+		chanP->useCnt++;
+		if ( chanP->useCnt == 1 ) {
+			/* first open: program the channel if not done yet */
+			if( !chanP->hwInit && LocBringUpChannel(chanP) != Z25_OK ){
+				chanP->useCnt--;
+				return(Z25_ERROR);
+			}
+			/* poll watchdog deleted at the last close */
+			if( (chanP->pollTicks > 0) && (chanP->pollWd == NULL) &&
+				(LocPollSet(chanP, chanP->pollTicks) != OK) ){
+				chanP->useCnt--;
+				return(Z25_ERROR);
+			}
+			/* Set UART to RS232 mode as default (enables the Receiver) */
+			MZ25_SetSerialMode(chanP->unitHdlP, MZ25_MODE_RS232);
+		}
+		return (int)chanP;
+	} else
+		return(Z25_ERROR);
+}/* LocChanOpen */
+
+
+/**********************************************************************/
+/** Routine to close a channel
+ *
+ * This routine is used by the tyLib to close a UART channel using the
+ * VxWorks function 'close()'.
+ *
+ *  \param fh	 file handle
+ *
+ *  \return OK
+ */
+LOCAL int LocClose( Z25_TY_CO_DEV_TS *chanP )
+{
+	switch (chanP->useCnt) {
+	case 0:
+		return(Z25_ERROR);
+		break;
+	case 1:	/* close last handle? -> disable Rx */
+		MZ25_REG_WRITE(chanP->addr, MIZ25_ACR_OFFSET,
+					   MZ25_REG_READ(chanP->addr, MIZ25_ACR_OFFSET) & ~MIZ25_RXEN);
+		/* caller owned Tx buffers must not be used after the close */
+		LocTxDescCancel(chanP);
+		/* stop polling, restarted at the next open */
+		LocPollStop(chanP);
+		chanP->useCnt--;
+		return(OK);
+	default:
+		chanP->useCnt--;
+		return(OK);
+	}
+}/* LocClose */
+
+/**********************************************************************/
+/** Routine to read from a channel
+ *
+ *  This routine is used by the ios to read from a UART channel using the
+ *  VxWorks function 'read(...)'. Without Rx framer the tyLib read is
+ *  used, with Rx framer one complete frame is returned per call. A frame
+ *  longer than maxBytes is truncated. The framer read blocks until a
+ *  frame arrives, use select() to wait with a timeout.
+ *
+ *  \param chanP            channel structure
+ *  \param bufP             buffer to store the data
+ *  \param maxBytes         buffer size
+ *
+ *  \return number of bytes read or ERROR (errno EIO if the framer was
+ *          replaced meanwhile)
+ */
+LOCAL int LocRead( Z25_TY_CO_DEV_TS *chanP,
+                   char *bufP,
+                   int maxBytes )
+{
+	Z25_FRAMER_TS *framerP;
+	int nBytes;
+
+	if( (framerP = LocFramerGet(chanP)) == NULL ){
+		return tyRead(&chanP->u.tyDev, bufP, maxBytes);
+	}
+
+	nBytes = msgQReceive(framerP->msgQId, bufP, (UINT)maxBytes,
+	                     WAIT_FOREVER);
+	if( (nBytes != ERROR) && framerP->detached ){
+		errnoSet(EIO);
+		nBytes = ERROR;
+	}
+
+	LocFramerPut(chanP, framerP);
+	return nBytes;
+}/* LocRead */
+
+
+/**********************************************************************/
+/** Routine to derive a software buffer size from the baudrate
+ *
+ *  The buffer holds Z25_BUFF_AUTO_MS of data (10 bit times per character)
+ *  at the given baudrate.
+ *
+ *  \param baudrate         channel baudrate
+ *  \param minSize          minimum buffer size
+ *
+ *  \return buffer size in bytes
+ */
+LOCAL u_int32 LocBuffSizeAuto(u_int32 baudrate, u_int32 minSize){
+    u_int32 size;
+
+    size = (baudrate / 10) * Z25_BUFF_AUTO_MS / 1000;
+
+    return (size > minSize) ? size : minSize;
+}/* LocBuffSizeAuto */
+
+/**********************************************************************/
+/** Routine to check if the tyLib buffers of a channel are idle
+ *
+ *  \param chanP            channel structure
+ *
+ *  \return TRUE if idle, FALSE if not
+ */
+LOCAL BOOL LocBuffIdle(Z25_TY_CO_DEV_TS *chanP){
+    return( (chanP->useCnt <= 1) &&
+            !chanP->u.tyDev.wrtState.busy &&
+            rngIsEmpty(chanP->u.tyDev.rdBuf) &&
+            rngIsEmpty(chanP->u.tyDev.wrtBuf) );
+}/* LocBuffIdle */
+
+/**********************************************************************/
+/** Routine to resize the tyLib Rx or Tx buffer of a channel
+ *
+ *  This routine replaces the ring buffer of an idle channel. The channel
+ *  must not be opened more than once, the buffers must be empty and no
+ *  transmission may be in progress. The tyLib mutex keeps readers and
+ *  writers of other tasks away and the channel interrupts are disabled
+ *  while the ring is swapped, data received meanwhile stays in the FIFO.
+ *
+ *  \param chanP            channel structure
+ *  \param tx               TRUE=Tx buffer, FALSE=Rx buffer
+ *  \param size             new size, Z25_BUFF_SIZE_AUTO=derived from baudrate
+ *
+ *  \return OK or ERROR (errno EBUSY if the channel is not idle)
+ */
+LOCAL STATUS LocResizeBuffer(Z25_TY_CO_DEV_TS *chanP, BOOL tx, u_int32 size){
+    RING_ID newRingP;           /* new ring buffer */
+    RING_ID oldRingP;           /* replaced ring buffer */
+    BOOL autoSize = FALSE;      /* size follows baudrate */
+    u_int8 ier;                 /* stored interrupt enable register */
+
+    if( chanP->created != LZ25_CREATE_TYPE_LATE ){
+        errnoSet(ENOSYS);
+        return ERROR;
+    }
+
+    if( size == Z25_BUFF_SIZE_AUTO ){
+        autoSize = TRUE;
+        size = LocBuffSizeAuto(chanP->uartUnit.baudrate,
+                               tx ? Z25_TX_BUFF_SIZE : Z25_RX_BUFF_SIZE);
+    }
+
+    if( size == (tx ? chanP->txBuffSize : chanP->rxBuffSize) ){
+        if( tx ){
+            chanP->txBuffAuto = autoSize;
+        }
+        else {
+            chanP->rxBuffAuto = autoSize;
+        }
+        return OK;
+    }
+
+    if( !LocBuffIdle(chanP) ){
+        errnoSet(EBUSY);
+        return ERROR;
+    }
+
+    if( (newRingP = rngCreate((int)size)) == NULL ){
+        DBGWRT_ERR((chanP->dbgHdlP,
+            "*** Z25/Z125 - Could not allocate %d byte buffer\n", size));
+        return ERROR;
+    }
+
+    /* keep tyRead/tyWrite of other tasks away from the rings */
+    if( semTake(&chanP->u.tyDev.mutexSem, WAIT_FOREVER) != OK ){
+        rngDelete(newRingP);
+        return ERROR;
+    }
+
+    /* keep the ISR away from the rings while swapping */
+    ier = MZ25_DisableInterrupt(chanP->unitHdlP, 0);
+#ifdef _WRS_CONFIG_SMP
+    /* let an ISR instance already running on another CPU finish */
+    taskDelay(1);
+#endif /* _WRS_CONFIG_SMP */
+
+    if( !LocBuffIdle(chanP) ){
+        MZ25_EnableInterrupt(chanP->unitHdlP, ier);
+        semGive(&chanP->u.tyDev.mutexSem);
+        rngDelete(newRingP);
+        errnoSet(EBUSY);
+        return ERROR;
+    }
+
+    if( tx ){
+        oldRingP = chanP->u.tyDev.wrtBuf;
+        chanP->u.tyDev.wrtBuf = newRingP;
+        chanP->txBuffSize = size;
+        chanP->txBuffAuto = autoSize;
+    }
+    else {
+        oldRingP = chanP->u.tyDev.rdBuf;
+        chanP->u.tyDev.rdBuf = newRingP;
+        chanP->rxBuffSize = size;
+        chanP->rxBuffAuto = autoSize;
+    }
+
+    MZ25_EnableInterrupt(chanP->unitHdlP, ier);
+
+    rngDelete(oldRingP);
+
+    semGive(&chanP->u.tyDev.mutexSem);
+
+    DBGWRT_2((chanP->dbgHdlP, "Z25/Z125 - %s buffer resized to %d bytes\n",
+        tx ? "Tx" : "Rx", size));
+
+    return OK;
+}/* LocResizeBuffer */
+
+/**********************************************************************/
+/** Routine to free an Rx framer
+ *
+ *  \param framerP          framer to free, may be NULL
+ *
+ *  \return no return value
+ */
+LOCAL void LocFramerFree(Z25_FRAMER_TS *framerP){
+    if( framerP == NULL ){
+        return;
+    }
+    if( framerP->rxWd != NULL ){
+        wdDelete(framerP->rxWd);
+    }
+    if( framerP->txWd != NULL ){
+        wdDelete(framerP->txWd);
+    }
+    if( framerP->msgQId != NULL ){
+        msgQDelete(framerP->msgQId);
+    }
+    if( framerP->bufP != NULL ){
+        free(framerP->bufP);
+    }
+    free(framerP);
+}/* LocFramerFree */
+
+/**********************************************************************/
+/** Routine to get the Rx framer of a channel for reading
+ *
+ *  The framer is kept until LocFramerPut(), even if LocFramerSet()
+ *  replaces it meanwhile. The channel lock is only taken if a framer
+ *  is set.
+ *
+ *  \param chanP            channel structure
+ *
+ *  \return framer or NULL if byte stream
+ */
+LOCAL Z25_FRAMER_TS *LocFramerGet( Z25_TY_CO_DEV_TS *chanP ){
+    Z25_FRAMER_TS *framerP;
+
+    /* byte stream: no lock in the tyLib path */
+    if( (chanP->created != LZ25_CREATE_TYPE_LATE) ||
+        (chanP->framerP == NULL) ||
+        (LocChanLock(chanP) != OK) ){
+        return NULL;
+    }
+    if( (framerP = chanP->framerP) != NULL ){
+        framerP->readers++;
+    }
+    LocChanUnlock(chanP);
+
+    return framerP;
+}/* LocFramerGet */
+
+/**********************************************************************/
+/** Routine to release the Rx framer got by LocFramerGet
+ *
+ *  The last reader frees a framer replaced by LocFramerSet().
+ *
+ *  \param chanP            channel structure
+ *  \param framerP          framer returned by LocFramerGet()
+ *
+ *  \return no return value
+ */
+LOCAL void LocFramerPut( Z25_TY_CO_DEV_TS *chanP,
+                         Z25_FRAMER_TS *framerP ){
+    BOOL doFree;
+
+    LocChanLock(chanP);
+    doFree = ((--framerP->readers == 0) && framerP->detached);
+    LocChanUnlock(chanP);
+
+    if( doFree ){
+        LocFramerFree(framerP);
+    }
+}/* LocFramerPut */
+
+/**********************************************************************/
+/** Routine to discard the complete frames of an Rx framer
+ *
+ *  \param framerP          framer of the channel
+ *
+ *  \return no return value
+ */
+LOCAL void LocFramerFlush( Z25_FRAMER_TS *framerP ){
+    char dummy;
+
+    /* longer frames are truncated to the dummy byte */
+    while( msgQReceive(framerP->msgQId, &dummy, 1, NO_WAIT) != ERROR )
+        ;
+}/* LocFramerFlush */
+
+/**********************************************************************/
+/** Routine to handle the read side io controls with Rx framer
+ *
+ *  Without framer the requests are passed to tyLib. With framer select()
+ *  also waits for complete frames and the flush requests discard them.
+ *  FIONREAD is not supported, the size of the next frame is unknown.
+ *
+ *  \param chanP            channel structure
+ *  \param request          FIONREAD, FIOFLUSH, FIORFLUSH or FIOSELECT
+ *  \param pArg             request argument
+ *
+ *  \return OK, ENOSYS if not supported or tyLib status
+ */
+LOCAL int LocFramerIoctl( Z25_TY_CO_DEV_TS *chanP,
+                          int request,
+                          void *pArg ){
+    Z25_FRAMER_TS *framerP;
+    int status;
+
+    if( chanP->created != LZ25_CREATE_TYPE_LATE ){
+        return ENOSYS;
+    }
+
+    if( (framerP = LocFramerGet(chanP)) == NULL ){
+        return tyIoctl(&chanP->u.tyDev, request, (int)pArg);
+    }
+
+    switch( request ){
+        case FIONREAD:
+            status = ENOSYS;
+            break;
+
+        case FIOSELECT:
+            /* tyLib adds the node and serves SELWRITE */
+            status = tyIoctl(&chanP->u.tyDev, request, (int)pArg);
+            if( (status == OK) &&
+                (selWakeupType((SEL_WAKEUP_NODE *)pArg) == SELREAD) &&
+                (msgQNumMsgs(framerP->msgQId) > 0) ){
+                selWakeup((SEL_WAKEUP_NODE *)pArg);
+            }
+            break;
+
+        default: /* FIOFLUSH, FIORFLUSH */
+            status = tyIoctl(&chanP->u.tyDev, request, (int)pArg);
+            LocFramerFlush(framerP);
+            break;
+    }
+
+    LocFramerPut(chanP, framerP);
+    return status;
+}/* LocFramerIoctl */
+
+/**********************************************************************/
+/** Routine to set the Rx framer of a channel
+ *
+ *  This routine checks the configuration, allocates the frame buffer and
+ *  frame queue and swaps them into the channel. The channel interrupts
+ *  are disabled and its watchdogs are stopped meanwhile, like in
+ *  LocResizeBuffer, so the ISR, LocPoll and the gap watchdog are done
+ *  with the previous framer before it is freed. A pending partial frame is
+ *  lost and a reader blocked in read() returns ERROR. A framer still used
+ *  by a reader is freed by that reader. A transmission delayed to the
+ *  Modbus RTU frame gap is started at once.
+ *
+ *  \param chanP            channel structure
+ *  \param cfgP             framer configuration, NULL=byte stream
+ *
+ *  \return OK, EIO if invalid configuration or ENOSYS if not supported
+ */
+LOCAL int LocFramerSet( Z25_TY_CO_DEV_TS *chanP,
+                        const MEN_UART_FRAMER *cfgP ){
+    Z25_FRAMER_TS *newP = NULL;     /* new framer */
+    Z25_FRAMER_TS *oldP;            /* replaced framer */
+    MEN_UART_FRAMER cfg;
+    int lockKey;
+    u_int32 i;
+    u_int8 ier;             /* stored interrupt enable register */
+    BOOL restart = FALSE;   /* restart a delayed transmission */
+
+    if( chanP->created != LZ25_CREATE_TYPE_LATE ){
+        return ENOSYS;
+    }
+
+    if( (cfgP != NULL) && (cfgP->mode != MEN_UART_FRAMER_NONE) ){
+        cfg = *cfgP;
+        if( cfg.maxFrame == 0 ){
+            cfg.maxFrame = IZ25_FRAMER_MAX_FRAME;
+        }
+        if( cfg.maxFrames == 0 ){
+            cfg.maxFrames = IZ25_FRAMER_MAX_FRAMES;
+        }
+
+        switch( cfg.mode ){
+            case MEN_UART_FRAMER_DELIMITER:
+            case MEN_UART_FRAMER_COBS:
+            case MEN_UART_FRAMER_MODBUS_RTU:
+                break;
+            case MEN_UART_FRAMER_LENGTH:
+                if( ((cfg.lenSize != 1) && (cfg.lenSize != 2) &&
+                     (cfg.lenSize != 4)) ||
+                    (cfg.lenOffset + cfg.lenSize > cfg.hdrSize) ||
+                    (cfg.hdrSize > cfg.maxFrame) ){
+                    return EIO;
+                }
+                break;
+            default:
+                return EIO;
+        }
+
+        if( (newP = (Z25_FRAMER_TS *)malloc(sizeof(Z25_FRAMER_TS))) == NULL ){
+            return EIO;
+        }
+        bzero((char *)newP, sizeof(Z25_FRAMER_TS));
+        newP->cfg = cfg;
+
+        newP->bufP = (u_int8 *)malloc(cfg.maxFrame);
+        newP->msgQId = msgQCreate((int)cfg.maxFrames, (int)cfg.maxFrame,
+                                  MSG_Q_FIFO);
+        if( (newP->bufP == NULL) || (newP->msgQId == NULL) ){
+            LocFramerFree(newP);
+            return EIO;
+        }
+
+        if( cfg.mode == MEN_UART_FRAMER_MODBUS_RTU ){
+            newP->crc = 0xffff;
+            newP->idleTick = tickGet();
+            newP->rxWd = wdCreate();
+            newP->txWd = wdCreate();
+            if( (newP->rxWd == NULL) || (newP->txWd == NULL) ){
+                LocFramerFree(newP);
+                return EIO;
+            }
+        }
+    }
+
+    if( LocChanLock(chanP) != OK ){
+        LocFramerFree(newP);
+        return EIO;
+    }
+
+    /* keep the ISR away from the framer while swapping */
+    ier = MZ25_DisableInterrupt(chanP->unitHdlP, 0);
+
+    lockKey = intLock();
+    oldP = chanP->framerP;
+    chanP->framerP = newP;
+    intUnlock(lockKey);
+
+    if( (oldP != NULL) && (oldP->txWd != NULL) ){
+        wdCancel(oldP->rxWd);
+        wdCancel(oldP->txWd);
+    }
+#ifdef _WRS_CONFIG_SMP
+    /* let an ISR, LocPoll or watchdog on another CPU finish */
+    taskDelay(1);
+    if( (oldP != NULL) && (oldP->txWd != NULL) ){
+        wdCancel(oldP->rxWd);
+        wdCancel(oldP->txWd);
+    }
+#endif /* _WRS_CONFIG_SMP */
+
+    MZ25_EnableInterrupt(chanP->unitHdlP, ier);
+
+    /* Modbus RTU: a Tx start delayed to the frame gap must not get lost */
+    if( (oldP != NULL) && (oldP->txWd != NULL) ){
+        restart = chanP->hwInit;
+    }
+
+    if( (oldP != NULL) && (oldP->readers > 0) ){
+        /* wake the readers with an empty message, the last one frees */
+        oldP->detached = TRUE;
+        for( i=0; i<oldP->readers; i++ ){
+            msgQSend(oldP->msgQId, (char *)oldP->bufP, 0, NO_WAIT,
+                     MSG_PRI_URGENT);
+        }
+        oldP = NULL;
+    }
+    LocChanUnlock(chanP);
+
+    LocFramerFree(oldP);
+
+    if( restart ){
+        LocStartup(chanP);
+    }
+
+    return OK;
+}/* LocFramerSet */
+
+/**********************************************************************/
+/** Routine to pass a complete frame to the reader
+ *
+ *  \param chanP            channel structure
+ *  \param framerP          framer of the channel
+ *
+ *  \return no return value
+ */
+LOCAL void LocFramerDone( Z25_TY_CO_DEV_TS *chanP,
+                          Z25_FRAMER_TS *framerP ){
+    /* read() would return 0, taken as end of file */
+    if( framerP->pos == 0 ){
+        return;
+    }
+
+    if( msgQSend(framerP->msgQId, (char *)framerP->bufP, framerP->pos,
+                 NO_WAIT, MSG_PRI_NORMAL) == OK ){
+        selWakeupAll(&chanP->u.tyDev.selWakeupList, SELREAD);
+        if( chanP->statsOn ){
+            chanP->stats.rxFrames++;
+        }
+    }
+    else if( chanP->statsOn ){
+        chanP->stats.rxFramesBad++;
+    }
+}/* LocFramerDone */
+
+/**********************************************************************/
+/** Routine to drop the frame under assembly
+ *
+ *  \param chanP            channel structure
+ *  \param framerP          framer of the channel
+ *  \param skip             TRUE=discard up to the next frame boundary
+ *
+ *  \return no return value
+ */
+LOCAL void LocFramerDrop( Z25_TY_CO_DEV_TS *chanP,
+                          Z25_FRAMER_TS *framerP,
+                          BOOL skip ){
+    if( chanP->statsOn ){
+        chanP->stats.rxFramesBad++;
+    }
+    framerP->pos      = 0;
+    framerP->frameLen = 0;
+    framerP->skip     = skip;
+}/* LocFramerDrop */
+
+/**********************************************************************/
+/** Routine to get the frame size from the header of a LENGTH frame
+ *
+ *  \param framerP          framer of the channel
+ *
+ *  \return frame size or 0 if invalid
+ */
+LOCAL u_int32 LocFramerLength( Z25_FRAMER_TS *framerP ){
+    const MEN_UART_FRAMER *cfgP = &framerP->cfg;
+    const u_int8 *fieldP = framerP->bufP + cfgP->lenOffset;
+    u_int32 len = 0;
+    int32 size;
+    int i;
+
+    for( i=0; i<cfgP->lenSize; i++ ){
+        if( cfgP->lenBigEndian ){
+            len = (len << 8) | fieldP[i];
+        }
+        else {
+            len |= (u_int32)fieldP[i] << (8 * i);
+        }
+    }
+
+    size = (int32)len + cfgP->lenAdjust;
+    if( (size < (int32)cfgP->hdrSize) || (size > (int32)cfgP->maxFrame) ){
+        return 0;
+    }
+
+    return (u_int32)size;
+}/* LocFramerLength */
+
+/**********************************************************************/
+/** Routine to run the Rx framer on received data
+ *
+ *  This routine is called from the receive interrupt with the data of a
+ *  burst. Complete frames are sent to the frame queue, oversize or
+ *  invalid frames are rejected as early as possible.
+ *  - DELIMITER: bytes up to the delimiter form a frame, an oversize frame
+ *    is discarded up to the next delimiter.
+ *  - LENGTH: the header gives the frame size, an invalid size discards
+ *    the header and the framer restarts with the next byte.
+ *  - COBS: the frame is decoded on the fly, 0x00 ends it.
+ *  - MODBUS_RTU: the CRC16 is updated per byte, the inter-frame gap
+ *    ends the frame (LocFramerRxEnd).
+ *
+ *  \param chanP            channel structure
+ *  \param framerP          framer of the channel
+ *  \param dataP            received data
+ *  \param len              number of bytes
+ *
+ *  \return no return value
+ */
+LOCAL void LocFramerRx( Z25_TY_CO_DEV_TS *chanP,
+                        Z25_FRAMER_TS *framerP,
+                        const u_int8 *dataP,
+                        u_int32 len ){
+    const MEN_UART_FRAMER *cfgP = &framerP->cfg;
+    u_int8 inByte;
+
+    while( len-- ){
+        inByte = *dataP++;
+
+        switch( cfgP->mode ){
+            case MEN_UART_FRAMER_DELIMITER:
+                if( inByte == cfgP->delimiter ){
+                    if( !framerP->skip && (framerP->pos > 0) ){
+                        LocFramerDone(chanP, framerP);
+                    }
+                    framerP->pos  = 0;
+                    framerP->skip = FALSE;
+                    continue;
+                }
+                break;
+
+            case MEN_UART_FRAMER_COBS:
+                if( inByte == 0x00 ){
+                    if( !framerP->skip && (framerP->cobsCode != 0) ){
+                        if( framerP->cobsLeft == 0 ){
+                            LocFramerDone(chanP, framerP);
+                        }
+                        else {
+                            /* truncated block */
+                            LocFramerDrop(chanP, framerP, FALSE);
+                        }
+                    }
+                    framerP->pos      = 0;
+                    framerP->skip     = FALSE;
+                    framerP->cobsCode = 0;
+                    framerP->cobsLeft = 0;
+                    continue;
+                }
+                if( framerP->skip ){
+                    continue;
+                }
+                if( framerP->cobsLeft == 0 ){
+                    /* code byte, the previous block ended with a zero */
+                    if( (framerP->cobsCode != 0) &&
+                        (framerP->cobsCode != 0xff) ){
+                        if( framerP->pos >= cfgP->maxFrame ){
+                            LocFramerDrop(chanP, framerP, TRUE);
+                            continue;
+                        }
+                        framerP->bufP[framerP->pos++] = 0x00;
+                    }
+                    framerP->cobsCode = inByte;
+                    framerP->cobsLeft = inByte - 1;
+                    continue;
+                }
+                framerP->cobsLeft--;
+                break;
+
+            case MEN_UART_FRAMER_LENGTH:
+                framerP->bufP[framerP->pos++] = inByte;
+                if( framerP->pos == cfgP->hdrSize ){
+                    if( (framerP->frameLen = LocFramerLength(framerP)) == 0 ){
+                        LocFramerDrop(chanP, framerP, FALSE);
+                        continue;
+                    }
+                }
+                if( (framerP->frameLen != 0) &&
+                    (framerP->pos == framerP->frameLen) ){
+                    LocFramerDone(chanP, framerP);
+                    framerP->pos      = 0;
+                    framerP->frameLen = 0;
+                }
+                continue;
+
+            case MEN_UART_FRAMER_MODBUS_RTU:
+                /* the frame ends with the gap, see LocFramerRxEnd */
+                if( framerP->skip ){
+                    continue;
+                }
+                if( framerP->pos >= cfgP->maxFrame ){
+                    LocFramerDrop(chanP, framerP, TRUE);
+                    continue;
+                }
+                framerP->bufP[framerP->pos++] = inByte;
+                framerP->crc = (framerP->crc >> 8) ^
+                    G_crc16Table[(framerP->crc ^ inByte) & 0xff];
+                continue;
+
+            default:
+                continue;
+        }
+
+        /* DELIMITER and COBS data byte */
+        if( framerP->skip ){
+            continue;
+        }
+        if( framerP->pos >= cfgP->maxFrame ){
+            LocFramerDrop(chanP, framerP, TRUE);
+            continue;
+        }
+        framerP->bufP[framerP->pos++] = inByte;
+    }
+}/* LocFramerRx */
+
+/**********************************************************************/
+/** Routine to convert a number of bit times to system clock ticks
+ *
+ *  The result is rounded up and one tick is added, because the current
+ *  tick is already partially elapsed.
+ *
+ *  \param chanP            channel structure
+ *  \param bits             number of bit times
+ *
+ *  \return number of ticks
+ */
+LOCAL u_int32 LocFramerTicks( Z25_TY_CO_DEV_TS *chanP,
+                              u_int32 bits ){
+    u_int32 baud = chanP->uartUnit.baudrate;
+
+    if( baud == 0 ){
+        baud = Z25_DEFAULT_BAUDRATE;
+    }
+
+    return ((bits * sysClkRateGet()) + baud - 1) / baud + 1;
+}/* LocFramerTicks */
+
+/**********************************************************************/
+/** Routine to finish a Modbus RTU frame at the inter-frame gap
+ *
+ *  The frame is passed if it is long enough and its CRC16 is valid
+ *  (the CRC over the whole ADU including the CRC field is 0).
+ *
+ *  \param chanP            channel structure
+ *  \param framerP          framer of the channel
+ *
+ *  \return no return value
+ */
+LOCAL void LocFramerRtuEnd( Z25_TY_CO_DEV_TS *chanP,
+                            Z25_FRAMER_TS *framerP ){
+    if( !framerP->skip && (framerP->pos > 0) ){
+        if( (framerP->pos >= IZ25_RTU_MIN_FRAME) && (framerP->crc == 0) ){
+            LocFramerDone(chanP, framerP);
+        }
+        else {
+            LocFramerDrop(chanP, framerP, FALSE);
+        }
+    }
+    framerP->pos  = 0;
+    framerP->skip = FALSE;
+    framerP->crc  = 0xffff;
+}/* LocFramerRtuEnd */
+
+/**********************************************************************/
+/** Routine to end a Modbus RTU frame by the gap timer
+ *
+ *  The UART raises no char timeout if the last burst emptied the FIFO,
+ *  the watchdog started by LocFramerRxEnd ends the frame instead. Bytes
+ *  below the Rx trigger level raise no interrupt before the char
+ *  timeout, so data in the FIFO is read first and the watchdog is
+ *  restarted instead of ending the frame.
+ *
+ *  \param chanP            channel structure
+ *
+ *  \return no return value
+ */
+LOCAL void LocFramerRtuWd( Z25_TY_CO_DEV_TS *chanP ){
+    Z25_FRAMER_TS *framerP = chanP->framerP;
+    int lockKey;
+
+    lockKey = intLock();
+    if( (framerP != NULL) &&
+        (framerP->cfg.mode == MEN_UART_FRAMER_MODBUS_RTU) ){
+        if( MZ25_LINE_STATUS(chanP->addr) & MIZ25_DR ){
+            /* frame still arriving, restarts the watchdog */
+            LocTyReceiveInt(chanP);
+            LocFramerRxEnd(chanP, FALSE);
+        }
+        else {
+            LocFramerRtuEnd(chanP, framerP);
+        }
+    }
+    intUnlock(lockKey);
+}/* LocFramerRtuWd */
+
+/**********************************************************************/
+/** Routine to detect the end of a Modbus RTU frame after a receive burst
+ *
+ *  The FIFO char timeout of the UART (4 char times without data) is used
+ *  as the 3.5 char inter-frame gap. Otherwise a watchdog of the gap time
+ *  ends the frame if no more data arrives. The end of bus activity is
+ *  stored to delay the next transmission (see LocStartup).
+ *
+ *  This is an approximation of the 3.5 char rule. A gap is detected
+ *  only if it lasts 4 char times (char timeout) or, if the burst emptied
+ *  the FIFO or the channel is polled, at least the gap time rounded up
+ *  to whole ticks plus one tick (LocFramerTicks). Frames sent back to
+ *  back with a shorter gap are merged and dropped by the CRC check, the
+ *  1.5 char inter-character limit is not checked.
+ *
+ *  \param chanP            channel structure
+ *  \param idle             TRUE=the line is idle (char timeout)
+ *
+ *  \return no return value
+ */
+LOCAL void LocFramerRxEnd( Z25_TY_CO_DEV_TS *chanP,
+                           BOOL idle ){
+    Z25_FRAMER_TS *framerP = chanP->framerP;
+    u_int32 gapTicks;
+
+    if( (framerP == NULL) ||
+        (framerP->cfg.mode != MEN_UART_FRAMER_MODBUS_RTU) ){
+        return;
+    }
+
+    gapTicks = LocFramerTicks(chanP, IZ25_RTU_GAP_BITS);
+    framerP->idleTick = tickGet() + gapTicks;
+
+    if( idle ){
+        wdCancel(framerP->rxWd);
+        LocFramerRtuEnd(chanP, framerP);
+    }
+    else if( framerP->pos > 0 ){
+        wdStart(framerP->rxWd, (int)gapTicks,
+                (FUNCPTR)LocFramerRtuWd, (int)chanP);
+    }
+}/* LocFramerRxEnd */
+
+/**********************************************************************/
+/** Routine to convert milliseconds to system clock ticks
+ *
+ *  \param ms               time in milliseconds
+ *
+ *  \return number of ticks, rounded up, at least 1
+ */
+LOCAL u_int32 LocMsToTicks( u_int32 ms ){
+    u_int32 ticks;
+
+    ticks = (ms * sysClkRateGet() + 999) / 1000;
+
+    return (ticks > 0) ? ticks : 1;
+}/* LocMsToTicks */
+
+/**********************************************************************/
+/** Routine to finish a transaction by the inter-char timeout
+ *
+ *  \param chanP            channel structure
+ *
+ *  \return no return value
+ */
+LOCAL void LocTransWd( Z25_TY_CO_DEV_TS *chanP ){
+    Z25_TRANS_TS *transP;
+    int lockKey;
+
+    lockKey = intLock();
+    if( ((transP = chanP->transP) != NULL) && !transP->done ){
+        transP->done = TRUE;
+        semGive(chanP->transSem);
+    }
+    intUnlock(lockKey);
+}/* LocTransWd */
+
+/**********************************************************************/
+/** Routine to store a response byte of a transaction
+ *
+ *  This routine is called by the receive interrupt while a transaction
+ *  is running. It checks the completion rules and wakes the caller of
+ *  LocTransaction once.
+ *
+ *  \param chanP            channel structure
+ *  \param transP           running transaction
+ *  \param inByte           received byte
+ *
+ *  \return no return value
+ */
+LOCAL void LocTransRx( Z25_TY_CO_DEV_TS *chanP,
+                       Z25_TRANS_TS *transP,
+                       u_int8 inByte ){
+    MEN_UART_TRANSACTION *reqP = transP->reqP;
+
+    if( transP->done ){
+        return;     /* late bytes are discarded */
+    }
+
+    reqP->rxBufP[transP->pos++] = inByte;
+
+    if( (transP->pos >= reqP->rxMax) ||
+        ((reqP->rxExpected != 0) && (transP->pos >= reqP->rxExpected)) ||
+        ((reqP->terminator >= 0) && (inByte == (u_int8)reqP->terminator)) ){
+        transP->done = TRUE;
+        if( transP->interTicks != 0 ){
+            wdCancel(chanP->transWd);
+        }
+        semGive(chanP->transSem);
+    }
+    else if( transP->interTicks != 0 ){
+        wdStart(chanP->transWd, (int)transP->interTicks,
+                (FUNCPTR)LocTransWd, (int)chanP);
+    }
+}/* LocTransRx */
+
+/**********************************************************************/
+/** Routine to create the transaction resources of a channel
+ *
+ *  \param chanP            channel structure
+ *
+ *  \return completion semaphore (the watchdog is stored in chanP) or
+ *          NULL if error
+ */
+LOCAL void *LocTransCreate( Z25_TY_CO_DEV_TS *chanP ){
+    SEM_ID semId;
+
+    if( (chanP->transWd == NULL) &&
+        ((chanP->transWd = wdCreate()) == NULL) ){
+        return NULL;
+    }
+
+    semId = semBCreate(SEM_Q_FIFO, SEM_EMPTY);
+
+    return (void *)semId;
+}/* LocTransCreate */
+
+/**********************************************************************/
+/** Routine to run a write-then-read transaction
+ *
+ *  This routine flushes the Rx buffer, transmits the request and
+ *  collects the response at driver level: the receive interrupt stores
+ *  the response bytes directly in the caller's buffer and wakes the
+ *  caller once the response is complete (expected length, terminator,
+ *  inter-char timeout or buffer full). The direction of RS485 lines is
+ *  switched by the UART (MEN_UART_IOCTL_AUTO_RS485).
+ *
+ *  The timeout runs from the request start, a blocking write of the
+ *  request is included.
+ *
+ *  \param chanP            channel structure
+ *  \param reqP             transaction, rxLen is set on return
+ *
+ *  \return OK or ERROR (errno ETIMEDOUT if the response is incomplete,
+ *          EBUSY if a transaction is running, EINVAL if invalid request,
+ *          ENOSYS if not supported, EIO if error)
+ */
+LOCAL int LocTransaction( Z25_TY_CO_DEV_TS *chanP,
+                          MEN_UART_TRANSACTION *reqP ){
+    Z25_TRANS_TS trans;
+    int lockKey;
+    int retVal = OK;
+    u_int32 endTick = 0;    /* end of the timeout */
+    int32 waitTicks = WAIT_FOREVER;
+
+    if( chanP->created != LZ25_CREATE_TYPE_LATE ){
+        errnoSet(ENOSYS);
+        return ERROR;
+    }
+
+    if( (reqP == NULL) || (reqP->rxBufP == NULL) || (reqP->rxMax == 0) ){
+        errnoSet(EINVAL);
+        return ERROR;
+    }
+    reqP->rxLen = 0;
+
+    if( reqP->timeoutMs != 0 ){
+        endTick = tickGet() + LocMsToTicks(reqP->timeoutMs);
+    }
+
+    if( LocChanResGet(chanP, (void **)&chanP->transSem,
+                      LocTransCreate) == NULL ){
+        errnoSet(EIO);
+        return ERROR;
+    }
+
+    bzero((char *)&trans, sizeof(trans));
+    trans.reqP = reqP;
+    if( reqP->interCharMs != 0 ){
+        trans.interTicks = LocMsToTicks(reqP->interCharMs);
+    }
+
+    /* stale data must not be taken as response */
+    LocFramerIoctl(chanP, FIORFLUSH, NULL);
+
+    lockKey = intLock();
+    if( chanP->transP != NULL ){
+        intUnlock(lockKey);
+        errnoSet(EBUSY);
+        return ERROR;
+    }
+    semTake(chanP->transSem, NO_WAIT);
+    chanP->transP = &trans;
+    intUnlock(lockKey);
+
+    if( (reqP->txLen > 0) &&
+        (tyWrite(&chanP->u.tyDev, (char *)reqP->txBufP, (int)reqP->txLen) !=
+         (int)reqP->txLen) ){
+        errnoSet(EIO);
+        retVal = ERROR;
+    }
+    else {
+        if( reqP->timeoutMs != 0 ){
+            /* time left after the write */
+            waitTicks = (int32)(endTick - tickGet());
+            if( waitTicks < 0 ){
+                waitTicks = NO_WAIT;
+            }
+        }
+        if( semTake(chanP->transSem, (int)waitTicks) != OK ){
+            errnoSet(ETIMEDOUT);
+            retVal = ERROR;
+        }
+    }
+
+    lockKey = intLock();
+    chanP->transP = NULL;
+    reqP->rxLen = trans.pos;
+    intUnlock(lockKey);
+    wdCancel(chanP->transWd);
+
+    return retVal;
+}/* LocTransaction */
+
+/**********************************************************************/
+/** Routine to create the Tx descriptor queue of a channel
+ *
+ *  \param chanP            channel structure
+ *
+ *  \return queue or NULL if error
+ */
+LOCAL void *LocTxDescQCreate( Z25_TY_CO_DEV_TS *chanP ){
+    Z25_TX_DESC_Q_TS *qP;
+
+    if( (qP = (Z25_TX_DESC_Q_TS *)malloc(sizeof(Z25_TX_DESC_Q_TS))) == NULL ){
+        return NULL;
+    }
+    bzero((char *)qP, sizeof(Z25_TX_DESC_Q_TS));
+    if( (qP->freeSem = semCCreate(SEM_Q_FIFO, IZ25_TX_DESC_MAX)) == NULL ){
+        free(qP);
+        return NULL;
+    }
+
+    return (void *)qP;
+}/* LocTxDescQCreate */
+
+/**********************************************************************/
+/** Routine to get the Tx descriptor queue of a channel
+ *
+ *  The queue is created at the first call of the channel.
+ *
+ *  \param chanP            channel structure
+ *
+ *  \return queue or NULL if error
+ */
+LOCAL Z25_TX_DESC_Q_TS *LocTxDescQGet( Z25_TY_CO_DEV_TS *chanP ){
+    return (Z25_TX_DESC_Q_TS *)LocChanResGet(chanP,
+                                             (void **)&chanP->txDescQP,
+                                             LocTxDescQCreate);
+}/* LocTxDescQGet */
+
+/**********************************************************************/
+/** Routine to queue caller owned Tx buffers
+ *
+ *  This routine queues the descriptors in order and starts the
+ *  transmitter. The transmit interrupt feeds the FIFO directly from the
+ *  caller's buffers after the tyLib Tx buffer has drained, so the data
+ *  is not copied and the transfer size is not limited by the ring size.
+ *  The routine blocks while all IZ25_TX_DESC_MAX slots are in use, it
+ *  returns before the data is sent. Writers of a channel must be
+ *  serialized by the caller. A started descriptor is sent completely
+ *  before tyLib data, write() data may go between two descriptors.
+ *  The descriptors are used at interrupt level, so only kernel tasks
+ *  may queue them.
+ *
+ *  \param chanP            channel structure
+ *  \param wvP              descriptors to queue, noQueued is set on
+ *                          return (also if EIO)
+ *
+ *  \return OK, EIO if error or ENOSYS if not supported
+ */
+LOCAL int LocTxDescQueue( Z25_TY_CO_DEV_TS *chanP,
+                          MEN_UART_WRITEV *wvP ){
+    Z25_TX_DESC_Q_TS *qP;
+    MEN_UART_TX_DESC *descP;
+    u_int32 i;
+    int lockKey;
+
+    if( chanP->created != LZ25_CREATE_TYPE_LATE ){
+        return ENOSYS;
+    }
+
+    if( (wvP == NULL) || ((wvP->descP == NULL) && (wvP->noDesc > 0)) ){
+        return EIO;
+    }
+    wvP->noQueued = 0;
+
+    if( (qP = LocTxDescQGet(chanP)) == NULL ){
+        return EIO;
+    }
+
+    for( i=0; i<wvP->noDesc; i++, wvP->noQueued++ ){
+        descP = &wvP->descP[i];
+        descP->done = 0;
+
+        if( (descP->len == 0) || (descP->bufP == NULL) ){
+            descP->done = 1;
+            if( descP->doneSem != NULL ){
+                semGive(descP->doneSem);
+            }
+            continue;
+        }
+
+        if( semTake(qP->freeSem, WAIT_FOREVER) != OK ){
+            return EIO;
+        }
+
+        lockKey = intLock();
+        qP->descP[qP->tail % IZ25_TX_DESC_MAX] = descP;
+        qP->bcastP[qP->tail % IZ25_TX_DESC_MAX] = NULL;
+        qP->tail++;
+        intUnlock(lockKey);
+
+        LocStartup(chanP);
+    }
+
+    return OK;
+}/* LocTxDescQueue */
+
+/**********************************************************************/
+/** Routine to cancel the queued Tx descriptors of a channel
+ *
+ *  The descriptors are removed from the queue, their done flag stays 0
+ *  and their doneSem is given. Bytes of the current descriptor already
+ *  in the FIFO are still sent.
+ *
+ *  \param chanP            channel structure
+ *
+ *  \return no return value
+ */
+LOCAL void LocTxDescCancel( Z25_TY_CO_DEV_TS *chanP ){
+    Z25_TX_DESC_Q_TS *qP = chanP->txDescQP;
+    Z25_BCAST_TS *bcastP;
+    SEM_ID doneSem;
+    u_int32 refCnt;
+    int lockKey;
+
+    if( qP == NULL ){
+        return;
+    }
+
+    lockKey = intLock();
+    while( qP->head != qP->tail ){
+        doneSem = qP->descP[qP->head % IZ25_TX_DESC_MAX]->doneSem;
+        bcastP  = qP->bcastP[qP->head % IZ25_TX_DESC_MAX];
+        refCnt  = (bcastP != NULL) ? --bcastP->refCnt : 1;
+        qP->offset = 0;
+        qP->head++;
+        intUnlock(lockKey);
+
+        if( doneSem != NULL ){
+            semGive(doneSem);
+        }
+        semGive(qP->freeSem);
+        /* last channel of a broadcast releases the shared copy */
+        if( refCnt == 0 ){
+            free(bcastP);
+        }
+
+        lockKey = intLock();
+    }
+    intUnlock(lockKey);
+}/* LocTxDescCancel */
+
+/**********************************************************************/
+/** Routine to feed the FIFO from the queued caller owned Tx buffers
+ *
+ *  This routine is called by the transmit interrupt. Drained descriptors
+ *  are marked done, their semaphore is given and the slot is freed.
+ *
+ *  \param chanP            channel structure
+ *  \param qP               descriptor queue of the channel
+ *  \param fifoBytes        free FIFO space
+ *
+ *  \return number of bytes written to the FIFO
+ */
+LOCAL u_int8 LocTxDescTx( Z25_TY_CO_DEV_TS *chanP,
+                          Z25_TX_DESC_Q_TS *qP,
+                          u_int8 fifoBytes ){
+    MEN_UART_TX_DESC *descP;
+    Z25_BCAST_TS *bcastP;
+    const u_int8 *dataP;
+    u_int32 chunk;
+    u_int8 noBytes = 0;
+
+    while( (fifoBytes > 0) && (qP->head != qP->tail) ){
+        descP = qP->descP[qP->head % IZ25_TX_DESC_MAX];
+
+        chunk = descP->len - qP->offset;
+        if( chunk > fifoBytes ){
+            chunk = fifoBytes;
+        }
+        fifoBytes -= (u_int8)chunk;
+        noBytes   += (u_int8)chunk;
+
+        dataP = descP->bufP + qP->offset;
+        qP->offset += chunk;
+        while( chunk-- ){
+            MZ25_WRITE_BYTE(chanP->addr, *dataP++);
+        }
+
+        if( qP->offset == descP->len ){
+            bcastP = qP->bcastP[qP->head % IZ25_TX_DESC_MAX];
+            qP->offset = 0;
+            qP->head++;
+            descP->done = 1;
+            if( descP->doneSem != NULL ){
+                semGive(descP->doneSem);
+            }
+            semGive(qP->freeSem);
+
+            /* last channel of a broadcast releases the shared copy */
+            if( bcastP != NULL ){
+                int lockKey = intLock();
+                u_int32 refCnt = --bcastP->refCnt;
+
+                intUnlock(lockKey);
+                if( refCnt == 0 ){
+                    excJobAdd((VOIDFUNCPTR)free, (int)bcastP, 0, 0, 0, 0, 0);
+                }
+            }
+        }
+    }
+
+    return noBytes;
+}/* LocTxDescTx */
+
+/**********************************************************************/
+/** Routine to free a bonded device
+ *
+ *  \param bondP            bonded device, may be partially created
+ *
+ *  \return no return value
+ */
+LOCAL void LocBondFree(Z25_BOND_TS *bondP){
+    if( bondP->rxWd != NULL ){
+        wdDelete(bondP->rxWd);
+    }
+    if( bondP->rxRing != NULL ){
+        rngDelete(bondP->rxRing);
+    }
+    if( bondP->rxSem != NULL ){
+        semDelete(bondP->rxSem);
+    }
+    if( bondP->rdSem != NULL ){
+        semDelete(bondP->rdSem);
+    }
+    if( bondP->txSem != NULL ){
+        semDelete(bondP->txSem);
+    }
+    free(bondP);
+}/* LocBondFree */
+
+/**********************************************************************/
+/** Routine to open a bonded device
+ *
+ *  The first open opens all member channels.
+ *
+ *  \param bondP            bonded device
+ *  \param name             device name (not used)
+ *  \param mode             device mode (not used)
+ *
+ *  \return address to bonded device or ERROR
+ */
+LOCAL int LocBondOpen( Z25_BOND_TS *bondP,
+                       char *name,
+                       int mode ){
+    u_int16 i;
+
+    if( LocSharedLock() != OK ){
+        return ERROR;
+    }
+
+    if( bondP->useCnt == 0 ){
+        for( i=0; i<bondP->noMembers; i++ ){
+            if( LocChanOpen(bondP->member[i].chanP) == Z25_ERROR ){
+                while( i-- > 0 ){
+                    LocClose(bondP->member[i].chanP);
+                }
+                LocSharedUnlock();
+                return ERROR;
+            }
+        }
+    }
+    bondP->useCnt++;
+
+    LocSharedUnlock();
+
+    return (int)bondP;
+}/* LocBondOpen */
+
+/**********************************************************************/
+/** Routine to close a bonded device
+ *
+ *  The last close closes all member channels.
+ *
+ *  \param bondP            bonded device
+ *
+ *  \return OK or ERROR
+ */
+LOCAL int LocBondClose( Z25_BOND_TS *bondP ){
+    u_int16 i;
+
+    if( LocSharedLock() != OK ){
+        return ERROR;
+    }
+
+    if( bondP->useCnt == 0 ){
+        LocSharedUnlock();
+        return ERROR;
+    }
+
+    if( --bondP->useCnt == 0 ){
+        for( i=0; i<bondP->noMembers; i++ ){
+            LocClose(bondP->member[i].chanP);
+        }
+    }
+
+    LocSharedUnlock();
+
+    return OK;
+}/* LocBondClose */
+
+/**********************************************************************/
+/** Routine to set the RTS line of all bond members
+ *
+ *  The peer stops sending while RTS is deasserted if its members use
+ *  RTS/CTS flow control. Must be called at interrupt level or with
+ *  interrupts locked.
+ *
+ *  \param bondP            bonded device
+ *  \param on               TRUE=assert RTS, FALSE=deassert RTS
+ *
+ *  \return no return value
+ */
+LOCAL void LocBondRts( Z25_BOND_TS *bondP,
+                       BOOL on ){
+    Z25_TY_CO_DEV_TS *chanP;
+    u_int8 mcr;
+    u_int16 i;
+
+    for( i=0; i<bondP->noMembers; i++ ){
+        chanP = bondP->member[i].chanP;
+        mcr = MZ25_REG_READ(chanP->addr, MIZ25_MCR_OFFSET);
+        if( on ){
+            mcr |= MIZ25_RTS;
+        }
+        else {
+            mcr &= ~MIZ25_RTS;
+        }
+        MZ25_REG_WRITE(chanP->addr, MIZ25_MCR_OFFSET, mcr);
+    }
+    bondP->rxHeld = !on;
+}/* LocBondRts */
+
+/**********************************************************************/
+/** Routine to move chunks stalled by a full Rx ring
+ *
+ *  This routine is started by the reader, it runs at interrupt level
+ *  like the receive interrupt which normally delivers the chunks. Once
+ *  all chunks are moved, the members assert RTS again.
+ *
+ *  \param bondP            bonded device
+ *
+ *  \return no return value
+ */
+LOCAL void LocBondRxWd( Z25_BOND_TS *bondP ){
+    int lockKey;
+
+    lockKey = intLock();
+    bondP->rxStalled = FALSE;
+    LocBondDeliver(bondP);
+    if( !bondP->rxStalled && bondP->rxHeld ){
+        LocBondRts(bondP, TRUE);
+    }
+    intUnlock(lockKey);
+}/* LocBondRxWd */
+
+/**********************************************************************/
+/** Routine to read from a bonded device
+ *
+ *  This routine blocks until reassembled data is available. The data
+ *  is copied without interrupt lock, the Rx ring is only put by
+ *  interrupt level. If chunks wait in the reorder window for ring
+ *  space, the watchdog moves them to the ring at the next tick.
+ *
+ *  \param bondP            bonded device
+ *  \param bufP             buffer to store the data
+ *  \param maxBytes         buffer size
+ *
+ *  \return number of bytes read or ERROR
+ */
+LOCAL int LocBondRead( Z25_BOND_TS *bondP,
+                       char *bufP,
+                       int maxBytes ){
+    int noBytes;
+
+    if( maxBytes <= 0 ){
+        return 0;
+    }
+
+    if( semTake(bondP->rdSem, WAIT_FOREVER) != OK ){
+        return ERROR;
+    }
+
+    while( (noBytes = rngBufGet(bondP->rxRing, bufP, maxBytes)) == 0 ){
+        if( semTake(bondP->rxSem, WAIT_FOREVER) != OK ){
+            noBytes = ERROR;
+            break;
+        }
+    }
+
+    if( (noBytes > 0) && bondP->rxStalled ){
+        wdStart(bondP->rxWd, 1, (FUNCPTR)LocBondRxWd, (int)bondP);
+    }
+
+    semGive(bondP->rdSem);
+
+    return noBytes;
+}/* LocBondRead */
+
+/**********************************************************************/
+/** Routine to write to a bonded device
+ *
+ *  This routine splits the data into chunks of up to IZ25_BOND_CHUNK
+ *  bytes and writes chunk n to the tyLib Tx buffer of member
+ *  n % noMembers. A chunk is sent as
+ *  sync, sequence number (2 bytes, MSB first), payload length,
+ *  payload and CRC16 (Modbus polynomial, LSB first) over sequence number,
+ *  length and payload. The routine blocks while the Tx buffer of the
+ *  next member is full, so all members transmit in parallel.
+ *
+ *  \param bondP            bonded device
+ *  \param bufP             data to send
+ *  \param nBytes           number of bytes
+ *
+ *  \return number of bytes written or ERROR
+ */
+LOCAL int LocBondWrite( Z25_BOND_TS *bondP,
+                        char *bufP,
+                        int nBytes ){
+    u_int8 frame[IZ25_BOND_FRAME];
+    Z25_TY_CO_DEV_TS *chanP;
+    u_int16 crc;
+    int len;
+    int done = 0;
+
+    if( semTake(bondP->txSem, WAIT_FOREVER) != OK ){
+        return ERROR;
+    }
+
+    while( done < nBytes ){
+        len = nBytes - done;
+        if( len > IZ25_BOND_CHUNK ){
+            len = IZ25_BOND_CHUNK;
+        }
+
+        frame[0] = IZ25_BOND_SYNC;
+        frame[1] = (u_int8)(bondP->txSeq >> 8);
+        frame[2] = (u_int8)bondP->txSeq;
+        frame[3] = (u_int8)len;
+        memcpy(&frame[4], bufP + done, len);
+        crc = LocBondCrc(0xffff, &frame[1], 3 + len);
+        frame[4 + len] = (u_int8)crc;
+        frame[5 + len] = (u_int8)(crc >> 8);
+
+        chanP = bondP->member[bondP->txSeq % bondP->noMembers].chanP;
+        if( tyWrite(&chanP->u.tyDev, (char *)frame, len + 6) != len + 6 ){
+            break;
+        }
+
+        bondP->txSeq++;
+        done += len;
+    }
+
+    semGive(bondP->txSem);
+
+    return ((done > 0) || (nBytes <= 0)) ? done : ERROR;
+}/* LocBondWrite */
+
+/**********************************************************************/
+/** Routine to handle the I/O controls of a bonded device
+ *
+ *  FIONREAD and FIORFLUSH work on the reassembled data, FIOFLUSH also
+ *  flushes the Rx ring. The line parameters (baudrate, hardware
+ *  options, data/stop bits, parity, flow control) and the Tx flush are
+ *  passed to every member channel, the get requests are answered by the
+ *  first member. Other requests would break the bond protocol and fail
+ *  with errno ENOTSUP.
+ *
+ *  \param bondP            bonded device
+ *  \param request          I/O control
+ *  \param arg              argument of the I/O control
+ *
+ *  \return OK, status of the first failing member or ERROR
+ */
+LOCAL int LocBondIoctl( Z25_BOND_TS *bondP,
+                        int request,
+                        void *arg ){
+    int status = OK;
+    int lockKey;
+    u_int16 i;
+
+    switch( request ){
+        case FIONREAD:
+            *(int *)arg = rngNBytes(bondP->rxRing);
+            return OK;
+
+        case FIORFLUSH:
+        case FIOFLUSH:
+            lockKey = intLock();
+            rngFlush(bondP->rxRing);
+            intUnlock(lockKey);
+            if( bondP->rxStalled ){
+                wdStart(bondP->rxWd, 1, (FUNCPTR)LocBondRxWd, (int)bondP);
+            }
+            if( request == FIORFLUSH ){
+                return OK;
+            }
+            break;
+
+        case SIO_BAUD_GET:
+        case SIO_HW_OPTS_GET:
+            return LocIoctl(bondP->member[0].chanP, request, arg);
+
+        case SIO_BAUD_SET:
+        case FIOBAUDRATE:
+        case SIO_HW_OPTS_SET:
+        case MEN_UART_IOCTL_DATABITS:
+        case MEN_UART_IOCTL_PARITY:
+        case MEN_UART_IOCTL_STOPBITS:
+        case MEN_UART_IOCTL_RTS_CTS:
+        case MEN_UART_IOCTL_FLOW_CONTROL:
+        case FIOWFLUSH:
+            break;
+
+        default:
+            errnoSet(ENOTSUP);
+            return ERROR;
+    }
+
+    for( i=0; (i<bondP->noMembers) && (status == OK); i++ ){
+        status = LocIoctl(bondP->member[i].chanP, request, arg);
+    }
+
+    return status;
+}/* LocBondIoctl */
+
+/**********************************************************************/
+/** Routine to compute the CRC16 of a bond chunk
+ *
+ *  \param crc              start value
+ *  \param dataP            data
+ *  \param len              number of bytes
+ *
+ *  \return CRC16
+ */
+LOCAL u_int16 LocBondCrc( u_int16 crc,
+                          const u_int8 *dataP,
+                          u_int32 len ){
+    while( len-- ){
+        crc = (crc >> 8) ^ G_crc16Table[(crc ^ *dataP++) & 0xff];
+    }
+    return crc;
+}/* LocBondCrc */
+
+/**********************************************************************/
+/** Routine to parse the received data of a bond member
+ *
+ *  This routine is called by the receive interrupt. Bytes up to the
+ *  next sync byte are skipped, a chunk with an invalid length or CRC is
+ *  counted as rxFramesBad. Its bytes after the sync byte are parsed
+ *  again, they may hold the next chunk if the sync byte was noise.
+ *
+ *  \param chanP            member channel
+ *  \param bondP            bonded device of the channel
+ *  \param dataP            received data
+ *  \param len              number of bytes
+ *
+ *  \return no return value
+ */
+LOCAL void LocBondRx( Z25_TY_CO_DEV_TS *chanP,
+                      Z25_BOND_TS *bondP,
+                      const u_int8 *dataP,
+                      u_int32 len ){
+    Z25_BOND_MEMBER_TS *memberP = &bondP->member[chanP->bondIdx];
+    u_int8 *bufP = memberP->rxBuf;
+    u_int8 inByte;
+    u_int16 chunkLen;
+    BOOL good;
+    u_int8 replay[IZ25_BOND_FRAME];   /* bytes of a bad chunk to parse again */
+    u_int32 noReplay = 0;
+    u_int32 replayIdx = 0;
+    u_int32 rest;
+
+    for(;;){
+        if( replayIdx < noReplay ){
+            inByte = replay[replayIdx++];
+        }
+        else if( len > 0 ){
+            inByte = *dataP++;
+            len--;
+        }
+        else {
+            break;
+        }
+
+        if( (memberP->pos == 0) && (inByte != IZ25_BOND_SYNC) ){
+            continue;
+        }
+        bufP[memberP->pos++] = inByte;
+
+        /* length byte */
+        if( memberP->pos == 4 ){
+            good = ( (inByte != 0) && (inByte <= IZ25_BOND_CHUNK) );
+            if( good ){
+                memberP->frameLen = inByte + 6;
+                continue;
+            }
+        }
+        else if( (memberP->pos < 4) || (memberP->pos != memberP->frameLen) ){
+            continue;
+        }
+        else {
+            chunkLen = memberP->frameLen - 6;
+            good = ( LocBondCrc(0xffff, &bufP[1], 3 + chunkLen) ==
+                     (u_int16)(bufP[4 + chunkLen] | (bufP[5 + chunkLen] << 8)) );
+            if( good ){
+                LocBondChunk(bondP, memberP,
+                             (u_int16)((bufP[1] << 8) | bufP[2]),
+                             &bufP[4], chunkLen);
+            }
+        }
+
+        if( chanP->statsOn ){
+            if( good ){
+                chanP->stats.rxFrames++;
+            }
+            else {
+                chanP->stats.rxFramesBad++;
+            }
+        }
+
+        if( !good ){
+            /* resync: parse the bytes after the sync byte again */
+            rest = noReplay - replayIdx;
+            memmove(&replay[memberP->pos - 1], &replay[replayIdx], rest);
+            memcpy(replay, &bufP[1], memberP->pos - 1);
+            noReplay  = memberP->pos - 1 + rest;
+            replayIdx = 0;
+        }
+        memberP->pos = 0;
+    }
+}/* LocBondRx */
+
+/**********************************************************************/
+/** Routine to put a received chunk into the reorder window
+ *
+ *  A chunk ahead of the window pushes the window forward, the skipped
+ *  chunks are lost. While the window waits for space in the Rx ring it
+ *  is not pushed, such a chunk is dropped instead (counted as rxDropped).
+ *  A chunk far away from the window (e.g. the sender was restarted)
+ *  restarts the reassembly at its sequence number. Duplicates of chunks
+ *  already delivered are dropped.
+ *
+ *  \param bondP            bonded device
+ *  \param memberP          member the chunk was received on
+ *  \param seq              sequence number of the chunk
+ *  \param dataP            payload
+ *  \param len              payload length
+ *
+ *  \return no return value
+ */
+LOCAL void LocBondChunk( Z25_BOND_TS *bondP,
+                         Z25_BOND_MEMBER_TS *memberP,
+                         u_int16 seq,
+                         const u_int8 *dataP,
+                         u_int16 len ){
+    u_int16 dist = (u_int16)(seq - bondP->rxSeq);
+    Z25_BOND_SLOT_TS *slotP;
+    u_int16 i;
+
+    if( dist >= 2 * bondP->window ){
+        if( (u_int16)(bondP->rxSeq - seq) <= 2 * bondP->window ){
+            /* duplicate */
+            return;
+        }
+
+        /* resynchronize */
+        for( i=0; i<bondP->window; i++ ){
+            bondP->slot[i].valid = FALSE;
+        }
+        for( i=0; i<bondP->noMembers; i++ ){
+            bondP->member[i].lastValid = FALSE;
+        }
+        bondP->rxSeq  = seq;
+        bondP->rxHead = 0;
+        dist = 0;
+    }
+
+    if( (dist >= bondP->window) && bondP->rxStalled ){
+        /* the peer ignored RTS, keep the chunks waiting for the reader */
+        if( memberP->chanP->statsOn ){
+            memberP->chanP->stats.rxDropped += len;
+        }
+        return;
+    }
+
+    while( dist >= bondP->window ){
+        LocBondAdvance(bondP);
+        dist--;
+    }
+
+    slotP = &bondP->slot[(bondP->rxHead + dist) % bondP->window];
+    memcpy(slotP->data, dataP, len);
+    slotP->len   = len;
+    slotP->valid = TRUE;
+
+    memberP->lastSeq   = seq;
+    memberP->lastValid = TRUE;
+
+    LocBondDeliver(bondP);
+}/* LocBondChunk */
+
+/**********************************************************************/
+/** Routine to move the reorder window by one chunk
+ *
+ *  The chunk at the window head is put into the Rx ring if it was
+ *  received and fits, otherwise it is lost and counted as rxDropped.
+ *
+ *  \param bondP            bonded device
+ *
+ *  \return no return value
+ */
+LOCAL void LocBondAdvance( Z25_BOND_TS *bondP ){
+    Z25_BOND_SLOT_TS *slotP = &bondP->slot[bondP->rxHead];
+    Z25_TY_CO_DEV_TS *chanP;
+
+    if( slotP->valid ){
+        if( rngFreeBytes(bondP->rxRing) >= slotP->len ){
+            rngBufPut(bondP->rxRing, (char *)slotP->data, slotP->len);
+            semGive(bondP->rxSem);
+        }
+        else {
+            /* counted on the member the chunk was received on */
+            chanP = bondP->member[bondP->rxSeq % bondP->noMembers].chanP;
+            if( chanP->statsOn ){
+                chanP->stats.rxDropped += slotP->len;
+            }
+        }
+        slotP->valid = FALSE;
+    }
+
+    bondP->rxSeq++;
+    bondP->rxHead = (bondP->rxHead + 1) % bondP->window;
+}/* LocBondAdvance */
+
+/**********************************************************************/
+/** Routine to move in order chunks to the Rx ring
+ *
+ *  Each member link keeps the order, so a missing chunk n is lost once
+ *  member n % noMembers received a later chunk. The window stops at a
+ *  chunk which does not fit into the Rx ring and deasserts RTS of the
+ *  members, the reader continues by LocBondRxWd. Must be called at
+ *  interrupt level with interrupts locked or from the receive interrupt.
+ *
+ *  \param bondP            bonded device
+ *
+ *  \return no return value
+ */
+LOCAL void LocBondDeliver( Z25_BOND_TS *bondP ){
+    Z25_BOND_SLOT_TS *slotP;
+    Z25_BOND_MEMBER_TS *memberP;
+
+    for(;;){
+        slotP = &bondP->slot[bondP->rxHead];
+        if( slotP->valid ){
+            if( rngFreeBytes(bondP->rxRing) < slotP->len ){
+                bondP->rxStalled = TRUE;
+                /* stop the peer until the reader made space */
+                if( !bondP->rxHeld ){
+                    LocBondRts(bondP, FALSE);
+                }
+                break;
+            }
+        }
+        else {
+            memberP = &bondP->member[bondP->rxSeq % bondP->noMembers];
+            if( !memberP->lastValid ||
+                (int16)(memberP->lastSeq - bondP->rxSeq) <= 0 ){
+                break;
+            }
+        }
+        LocBondAdvance(bondP);
+    }
+}/* LocBondDeliver */
+
+/**********************************************************************/
+/** Routine to create the urgent message queue of a channel
+ *
+ *  \param chanP            channel structure
+ *
+ *  \return ring buffer or NULL if error
+ */
+LOCAL void *LocUrgentCreate( Z25_TY_CO_DEV_TS *chanP ){
+    return (void *)rngCreate(IZ25_URGENT_SIZE);
+}/* LocUrgentCreate */
+
+/**********************************************************************/
+/** Routine to queue an urgent message
+ *
+ *  This routine copies the message into the high priority Tx queue of
+ *  the channel and starts the transmitter. The transmit interrupt
+ *  drains this queue before any other Tx data, so the message waits at
+ *  most for the FIFO content already being sent. The message is queued
+ *  completely or not at all.
+ *
+ *  \param chanP            channel structure
+ *  \param msgP             message
+ *
+ *  \return OK, ERROR (errno EAGAIN if the queue is full) or EIO
+ */
+LOCAL int LocUrgentWrite( Z25_TY_CO_DEV_TS *chanP,
+                          MEN_UART_URGENT *msgP ){
+    int lockKey;
+    int retVal = OK;
+
+    if( (msgP == NULL) || (msgP->bufP == NULL) ||
+        (msgP->len == 0) || (msgP->len > IZ25_URGENT_SIZE) ){
+        return EIO;
+    }
+
+    /* created at the first urgent message of the channel */
+    if( LocChanResGet(chanP, (void **)&chanP->urgentRing,
+                      LocUrgentCreate) == NULL ){
+        return EIO;
+    }
 
-    if( hdlP == NULL ){
-        return Z25_ERROR;
+    lockKey = intLock();
+    if( rngFreeBytes(chanP->urgentRing) < (int)msgP->len ){
+        retVal = ERROR;
     }
     else {
-        z25HdlP = hdlP;
+        rngBufPut(chanP->urgentRing, (char *)msgP->bufP, (int)msgP->len);
     }
+    intUnlock(lockKey);
 
-    /* Z125 uart detected */
-    if( uartCore == IZ25_MODID_2 ){
-        loopIndex = IZ25_MIN_UARTS_PER_DEV;
-         DBGWRT_1((z25HdlP->dbgHdlP,
-        "Z25/Z125 - module id 0x%x / Z125 uart core detected !\n",
-            uartCore));
+    if( retVal != OK ){
+        errnoSet(EAGAIN);
+        return ERROR;
     }
-    else {
-        loopIndex = Z25_MAX_UARTS_PER_DEV;
-        DBGWRT_1((z25HdlP->dbgHdlP,
-        "Z25/Z125 - module id 0x%x / Z25 uart core detected !\n",
-            uartCore));
 
-        uartsExist = MZ25_UARTS_EXISTING((u_int32)(address));
+    LocStartup(chanP);
 
-        if( uartsExist == 0 ){
-            DBGWRT_ERR((z25HdlP->dbgHdlP,
-            "*** Z25/Z125 - No UART channel detected ! \n"));
-            return Z25_ERROR;
-        }
-    }/* end if */
+    return OK;
+}/* LocUrgentWrite */
 
-    if( loopIndex == 0 ){
-        DBGWRT_ERR((z25HdlP->dbgHdlP,
-        "*** Z25/Z125 - No UART channel detected ! \n"));
-        return Z25_ERROR;
-    }/* end if */
+/**********************************************************************/
+/** Routine to feed the FIFO from the high priority Tx queue
+ *
+ *  \param chanP            channel structure
+ *  \param fifoBytes        free FIFO space
+ *
+ *  \return number of bytes written to the FIFO
+ */
+LOCAL u_int8 LocUrgentTx( Z25_TY_CO_DEV_TS *chanP,
+                          u_int8 fifoBytes ){
+    u_int8 txBuf[IZ25_SIO_BLOCK_SIZE];
+    int len, i;
 
-    for( i=0; i<loopIndex; i++ ){
-        u_int8 uartMask = 0;
+    if( (chanP->urgentRing == NULL) || rngIsEmpty(chanP->urgentRing) ){
+        return 0;
+    }
 
-        /* set pointer to UART channel */
-        tmpQuadUartP =
-            &z25HdlP->quadUart[z25HdlP->no16Z25Dev][i];
+    len = rngBufGet(chanP->urgentRing, (char *)txBuf,
+                    (fifoBytes < IZ25_SIO_BLOCK_SIZE) ?
+                     fifoBytes : IZ25_SIO_BLOCK_SIZE);
+    for( i=0; i<len; i++ ){
+        MZ25_WRITE_BYTE(chanP->addr, txBuf[i]);
+    }
 
-        tmpQuadUartP->baseAddr = address;
+    return (u_int8)len;
+}/* LocUrgentTx */
 
-        uartMask = 1 << i;
+/**********************************************************************/
+/** Routine to start a time scheduled message
+ *
+ *  This routine is called at the transmit time, by the alarm function
+ *  at interrupt level or by LocTimedWait. The message is sent by the
+ *  THRE path, LocStartup loads the first FIFO-full at once if the
+ *  transmitter is idle. A call before the transmit time of the message,
+ *  e.g. the alarm of a timed out message, is ignored.
+ *
+ *  \param chanP            channel structure
+ *
+ *  \return no return value
+ */
+LOCAL void LocTimedFire( Z25_TY_CO_DEV_TS *chanP ){
+    Z25_TIMED_TX_TS *timedP = chanP->timedP;
+    int lockKey;
+
+    lockKey = intLock();
+    if( (timedP == NULL) || (timedP->reqP == NULL) || timedP->active ||
+        ((int32)(timedP->reqP->txTime -
+                 (u_int32)(*G_Z25_TimeGetP)()) > 0) ){
+        intUnlock(lockKey);
+        return;
+    }
+    timedP->active = TRUE;
+    intUnlock(lockKey);
 
-        /* check if UART exists */
-        if( ((uartsExist&uartMask) != uartMask) &&
-            (uartCore != IZ25_MODID_2) ){
-            tmpQuadUartP->addr = 0;
-        }
-        else {/* fill channel structure */
-            if( uartCore == IZ25_MODID_2 ){
-                tmpQuadUartP->addr = (u_int32)address;
-            }
-            else {
-                tmpQuadUartP->addr = (u_int32)(address + i*IZ25_CHANNEL_OFFSET);
-            } /* end if */
-            tmpQuadUartP->channel = z25HdlP->noUarts++;
-            tmpQuadUartP->dbgHdlP = z25HdlP->dbgHdlP;
+    LocStartup(chanP);
+}/* LocTimedFire */
 
-            tmpHdlP = NULL;
-            /* yes, create MZ25 handle */
-            if( MZ25_InitHandle
-                ((HDL_16Z25 **)&tmpHdlP,
-                tmpQuadUartP->addr ) == 0 ){   /* store 16Z25 handle to channel structure */
-                z25HdlP->quadUart[z25HdlP->no16Z25Dev][i].unitHdlP =
-                    tmpHdlP;
-            }
-            else {
-                DBGWRT_ERR((z25HdlP->dbgHdlP,
-                "*** Z25/Z125 - Could not allocate memory for 16Z25 handle\n"));
-                return Z25_ERROR;
-            }
+/**********************************************************************/
+/** Routine to wait for the transmit time without BSP alarm function
+ *
+ *  This routine delays the calling task while the transmit time is one
+ *  tick or more ahead and polls the time base for the last part of a
+ *  tick, then it starts the message.
+ *
+ *  \param chanP            channel structure
+ *  \param txTime           transmit time
+ *
+ *  \return no return value
+ */
+LOCAL void LocTimedWait( Z25_TY_CO_DEV_TS *chanP,
+                         u_int32 txTime ){
+    int32 delta;
+    u_int32 ticks;
+
+    while( (delta = (int32)(txTime - (u_int32)(*G_Z25_TimeGetP)())) > 0 ){
+        ticks = (u_int32)(((UINT64)delta * sysClkRateGet()) / G_Z25_TimeFreq);
+        if( ticks > 0 ){
+            taskDelay((int)ticks);
         }
-        /* register interrupt */
-        tmpQuadUartP->irq = irq;
-        tmpQuadUartP->irqvec = irq + z25HdlP->irqFct.extIrqBase;
-        tmpQuadUartP->uartCore = uartCore;
     }
 
-    /* increment unit number */
-    ++z25HdlP->no16Z25Dev;
-
-    return Z25_OK;
-}/* LocInitUartUnit */
+    LocTimedFire(chanP);
+}/* LocTimedWait */
 
 /**********************************************************************/
-/** Routine to Create a channel
+/** Routine to create the scheduled message state of a channel
  *
  *  \param chanP            channel structure
- *  \param name             device name (used by tyLib)
- *  \param mode             device mode (used by tyLib)
  *
- *  \return address to channel structure
+ *  \return state or NULL if error
  */
-LOCAL int LocCreate( Z25_TY_CO_DEV_TS *chanP,
-                   int8 *name,
-                   int mode )
-{
-    return (int)chanP;
-}/* LocCreate */
+LOCAL void *LocTimedCreate( Z25_TY_CO_DEV_TS *chanP ){
+    Z25_TIMED_TX_TS *timedP;
+
+    if( (timedP = (Z25_TIMED_TX_TS *)malloc(sizeof(Z25_TIMED_TX_TS))) == NULL ){
+        return NULL;
+    }
+    bzero((char *)timedP, sizeof(Z25_TIMED_TX_TS));
+    if( (timedP->doneSem = semBCreate(SEM_Q_FIFO, SEM_EMPTY)) == NULL ){
+        free(timedP);
+        return NULL;
+    }
+
+    return (void *)timedP;
+}/* LocTimedCreate */
 
 /**********************************************************************/
-/** Routine to open a channel
+/** Routine to send a message at an absolute time
  *
- *  This routine is used by the tyLib to open a UART channel using the
- *  VxWorks function 'open(...)'.
+ *  This routine holds the message until the transmit time of the time
+ *  base (see Z25_SetTimeBase) and returns when the message is loaded
+ *  into the FIFO. The start time is the time the first byte was loaded.
+ *  The alarm function of the BSP calls LocTimedFire at the transmit
+ *  time, without it the calling task waits (see LocTimedWait). One
+ *  message per channel can be scheduled. The caller is protected from
+ *  deletion until the message is loaded or timed out, the wait ends
+ *  IZ25_TIMED_TX_SLACK seconds after the time the message needs.
  *
  *  \param chanP            channel structure
- *  \param name             device name (used by tyLib)
- *  \param mode             device mode (used by tyLib)
+ *  \param reqP             message, startTime is set on return
  *
- *  \return address to channel structure
+ *  \return OK, ERROR (errno EBUSY if a message is scheduled, ETIMEDOUT
+ *          if not loaded in time), EIO or ENOSYS if no time base is set
  */
-LOCAL int LocOpen( Z25_TY_CO_DEV_TS *chanP )
-{
-	if (chanP != NULL) {
-		chanP->useCnt++;
-		if ( chanP->useCnt == 1 ) {
-			/* first open: Set UART to RS232 mode as default (enables the Receiver) */
-			MZ25_SetSerialMode(chanP->unitHdlP, MZ25_MODE_RS232);
-		}
-		return (int)chanP;
-	} else
-		return(Z25_ERROR);
-}/* LocCreate */
+LOCAL int LocTimedWrite( Z25_TY_CO_DEV_TS *chanP,
+                         MEN_UART_TIMED_TX *reqP ){
+    Z25_TIMED_TX_TS *timedP;
+    int lockKey;
+    int32 delta;
+    u_int32 waitTicks;
+    STATUS done;
+
+    if( (chanP->created != LZ25_CREATE_TYPE_LATE) ||
+        (G_Z25_TimeGetP == NULL) ){
+        return ENOSYS;
+    }
+
+    if( (reqP == NULL) || (reqP->bufP == NULL) || (reqP->len == 0) ){
+        return EIO;
+    }
+
+    /* created at the first scheduled message of the channel */
+    if( (timedP = (Z25_TIMED_TX_TS *)LocChanResGet(chanP,
+                      (void **)&chanP->timedP, LocTimedCreate)) == NULL ){
+        return EIO;
+    }
+
+    /* reqP must not point to the stack of a deleted task */
+    taskSafe();
+
+    lockKey = intLock();
+    if( timedP->reqP != NULL ){
+        intUnlock(lockKey);
+        taskUnsafe();
+        errnoSet(EBUSY);
+        return ERROR;
+    }
+    /* a late give of a timed out message */
+    semTake(timedP->doneSem, NO_WAIT);
+    timedP->reqP   = reqP;
+    timedP->offset = 0;
+    timedP->active = FALSE;
+    intUnlock(lockKey);
+
+    /* time to load the message after the transmit time */
+    waitTicks = LocFramerTicks(chanP, reqP->len * 11) +
+                IZ25_TIMED_TX_SLACK * sysClkRateGet();
+
+    if( (G_Z25_TimeAlarmP == NULL) ||
+        ((*G_Z25_TimeAlarmP)(reqP->txTime, (FUNCPTR)LocTimedFire,
+                             (int)chanP) != OK) ){
+        LocTimedWait(chanP, reqP->txTime);
+    }
+    else {
+        delta = (int32)(reqP->txTime - (u_int32)(*G_Z25_TimeGetP)());
+        if( delta > 0 ){
+            waitTicks += (u_int32)(((UINT64)delta * sysClkRateGet()) /
+                                   G_Z25_TimeFreq) + 1;
+        }
+    }
+
+    done = semTake(timedP->doneSem, (int)waitTicks);
+
+    lockKey = intLock();
+    if( timedP->reqP == reqP ){
+        /* not loaded completely, the alarm is ignored (LocTimedFire) */
+        timedP->reqP   = NULL;
+        timedP->active = FALSE;
+        done = ERROR;
+    }
+    intUnlock(lockKey);
+
+    taskUnsafe();
+
+    if( done != OK ){
+        errnoSet(ETIMEDOUT);
+        return ERROR;
+    }
 
+    return OK;
+}/* LocTimedWrite */
 
 /**********************************************************************/
-/** Routine to close a channel
- *
- * This routine is used by the tyLib to close a UART channel using the
- * VxWorks function 'close()'.
+/** Routine to feed the FIFO from the time scheduled message
  *
- *  \param fh	 file handle
+ *  \param chanP            channel structure
+ *  \param fifoBytes        free FIFO space
  *
- *  \return OK
+ *  \return number of bytes written to the FIFO
  */
-LOCAL int LocClose( Z25_TY_CO_DEV_TS *chanP )
-{
-	switch (chanP->useCnt) {
-	case 0:
-		return(Z25_ERROR);
-		break;
-	case 1:	/* close last handle? -> disable Rx */
-		MZ25_REG_WRITE(chanP->addr, MIZ25_ACR_OFFSET,
-					   MZ25_REG_READ(chanP->addr, MIZ25_ACR_OFFSET) &=~MIZ25_RXEN);
-		chanP->useCnt--;
-		return(OK);
-	default:
-		chanP->useCnt--;
-		return(OK);
-	}
-}/* LocClose */
+LOCAL u_int8 LocTimedTx( Z25_TY_CO_DEV_TS *chanP,
+                         u_int8 fifoBytes ){
+    Z25_TIMED_TX_TS *timedP = chanP->timedP;
+    MEN_UART_TIMED_TX *reqP;
+    u_int32 chunk;
+    const u_int8 *dataP;
+
+    if( (timedP == NULL) || !timedP->active ){
+        return 0;
+    }
+    reqP = timedP->reqP;
+
+    if( timedP->offset == 0 ){
+        reqP->startTime = (u_int32)(*G_Z25_TimeGetP)();
+    }
+
+    chunk = reqP->len - timedP->offset;
+    if( chunk > fifoBytes ){
+        chunk = fifoBytes;
+    }
+    dataP = reqP->bufP + timedP->offset;
+    timedP->offset += chunk;
+    fifoBytes = (u_int8)chunk;
+    while( chunk-- ){
+        MZ25_WRITE_BYTE(chanP->addr, *dataP++);
+    }
+
+    if( timedP->offset == reqP->len ){
+        timedP->active = FALSE;
+        timedP->reqP   = NULL;
+        semGive(timedP->doneSem);
+    }
 
+    return fifoBytes;
+}/* LocTimedTx */
 
 /**********************************************************************/
 /** Routine to handle device control requests
@@ -1630,10 +5115,22 @@ LOCAL int LocIoctl(Z25_TY_CO_DEV_TS *chanP,
             }/* end if */
 
             status = MZ25_SetBaudrate(chanP->unitHdlP, arg);
+
+            /* grow auto sized buffers, keep them if the channel is busy */
+            if( (status == OK) && (chanP->created == LZ25_CREATE_TYPE_LATE) ){
+                if( chanP->rxBuffAuto &&
+                    (LocBuffSizeAuto(arg, Z25_RX_BUFF_SIZE) > chanP->rxBuffSize) ){
+                    LocResizeBuffer(chanP, FALSE, Z25_BUFF_SIZE_AUTO);
+                }
+                if( chanP->txBuffAuto &&
+                    (LocBuffSizeAuto(arg, Z25_TX_BUFF_SIZE) > chanP->txBuffSize) ){
+                    LocResizeBuffer(chanP, TRUE, Z25_BUFF_SIZE_AUTO);
+                }
+            }
             break;
 
         case SIO_BAUD_GET:
-            *(int *)pArg = ((TS_16Z25_UNIT *)chanP->unitHdlP)->baudrate;
+            *(int *)pArg = chanP->uartUnit.baudrate;
             break;
 
         case SIO_HW_OPTS_SET:
@@ -1783,53 +5280,174 @@ LOCAL int LocIoctl(Z25_TY_CO_DEV_TS *chanP,
             status = MZ25_SetSerialMode(chanP->unitHdlP, MZ25_MODE_RS485_HD);
             break;
 
-        case MEN_UART_IOCTL_MODE_GET:
-            switch(MZ25_GetSerialMode(chanP->unitHdlP)){
-                case MZ25_MODE_RS232: /* RS232 */
-                default:
-                    status = 0;
-                    break;
-                case MZ25_MODE_RS485_HD: /* RS485 - half duplex */
-                    status = 1;
-                    break;
-                case MZ25_MODE_RS485_FD: /* RS485 - full duplex */
-                    status = 2;
-                    break;
-            }
+        case MEN_UART_IOCTL_MODE_GET:
+            switch(MZ25_GetSerialMode(chanP->unitHdlP)){
+                case MZ25_MODE_RS232: /* RS232 */
+                default:
+                    status = 0;
+                    break;
+                case MZ25_MODE_RS485_HD: /* RS485 - half duplex */
+                    status = 1;
+                    break;
+                case MZ25_MODE_RS485_FD: /* RS485 - full duplex */
+                    status = 2;
+                    break;
+            }
+            break;
+
+        case MEN_UART_IOCTL_MODEM:
+            if( arg == 1 ){
+                status = MZ25_SetModemControl(chanP->unitHdlP, TRUE);
+            }
+            else{
+                status = MZ25_SetModemControl(chanP->unitHdlP, FALSE);
+            }
+            break;
+
+        case MEN_UART_IOCTL_SET_FIFO_BYTES:
+            status = MZ25_SetFifoTriggerLevel(chanP->unitHdlP, 0, arg);
+            break;
+
+        case MEN_UART_IOCTL_SET_TX_FIFO_BYTES:
+            status = MZ25_SetFifoTriggerLevel(chanP->unitHdlP, 1, arg);
+            break;
+
+        case MEN_UART_IOCTL_LINE_STATUS:
+            status = MZ25_GetLineStatus(chanP->unitHdlP);
+            break;
+
+        case MEN_UART_IOCTL_SET_RX_BUFF_SIZE:
+            status = LocResizeBuffer(chanP, FALSE, (u_int32)arg);
+            break;
+
+        case MEN_UART_IOCTL_SET_TX_BUFF_SIZE:
+            status = LocResizeBuffer(chanP, TRUE, (u_int32)arg);
+            break;
+
+        case MEN_UART_IOCTL_GET_RX_BUFF_SIZE:
+            *(u_int32 *)pArg = chanP->rxBuffSize;
+            break;
+
+        case MEN_UART_IOCTL_GET_TX_BUFF_SIZE:
+            *(u_int32 *)pArg = chanP->txBuffSize;
+            break;
+
+        case MEN_UART_IOCTL_RTS_CTS:
+            status = LocFlowCtrlSet(chanP, (arg == 1) ?
+                         MEN_UART_FLOW_RTS_CTS : MEN_UART_FLOW_NONE);
+            break;
+
+        case MEN_UART_IOCTL_XON_XOFF:
+            status = LocFlowCtrlSet(chanP, (arg == 1) ?
+                         MEN_UART_FLOW_XON_XOFF : MEN_UART_FLOW_NONE);
+            break;
+
+        case MEN_UART_IOCTL_DTR_DSR:
+            status = LocFlowCtrlSet(chanP, (arg == 1) ?
+                         MEN_UART_FLOW_DTR_DSR : MEN_UART_FLOW_NONE);
+            break;
+
+        case MEN_UART_IOCTL_HANDSHAKE_OFF:
+            status = LocFlowCtrlSet(chanP, MEN_UART_FLOW_NONE);
+            break;
+
+        case MEN_UART_IOCTL_FLOW_CONTROL:
+            status = LocFlowCtrlSet(chanP, (u_int32)arg);
+            break;
+
+        case SIO_MODE_SET:
+            status = LocSioModeSet(chanP, arg);
+            break;
+
+        case SIO_MODE_GET:
+            if( chanP->created == LZ25_CREATE_TYPE_AT_BOOT ){
+                *(int *)pArg = chanP->u.sioT.mode;
+            }
+            else {
+                status = ENOSYS;
+            }
+            break;
+
+        case SIO_AVAIL_MODES_GET:
+            if( chanP->created == LZ25_CREATE_TYPE_AT_BOOT ){
+                *(int *)pArg = SIO_MODE_INT | SIO_MODE_POLL;
+            }
+            else {
+                status = ENOSYS;
+            }
+            break;
+
+        case MEN_UART_IOCTL_FRAMER:
+            status = LocFramerSet(chanP, (const MEN_UART_FRAMER *)pArg);
+            break;
+
+        case FIOFLUSH:
+            LocTxDescCancel(chanP);
+            status = LocFramerIoctl(chanP, request, pArg);
+            break;
+
+        case FIONREAD:
+        case FIORFLUSH:
+        case FIOSELECT:
+            status = LocFramerIoctl(chanP, request, pArg);
+            break;
+
+        case FIOWFLUSH:
+            LocTxDescCancel(chanP);
+            status = (chanP->created == LZ25_CREATE_TYPE_LATE) ?
+                     tyIoctl(&chanP->u.tyDev, request, arg) : ENOSYS;
+            break;
+
+        case MEN_UART_IOCTL_TRANSACTION:
+            status = LocTransaction(chanP, (MEN_UART_TRANSACTION *)pArg);
+            break;
+
+        case MEN_UART_IOCTL_WRITEV:
+            status = LocTxDescQueue(chanP, (MEN_UART_WRITEV *)pArg);
+            break;
+
+        case MEN_UART_IOCTL_WRITE_URGENT:
+            status = LocUrgentWrite(chanP, (MEN_UART_URGENT *)pArg);
+            break;
+
+        case MEN_UART_IOCTL_WRITE_AT:
+            status = LocTimedWrite(chanP, (MEN_UART_TIMED_TX *)pArg);
             break;
 
-        case MEN_UART_IOCTL_MODEM:
-            if( arg == 1 ){
-                status = MZ25_SetModemControl(chanP->unitHdlP, TRUE);
-            }
-            else{
-                status = MZ25_SetModemControl(chanP->unitHdlP, FALSE);
-            }
+        case MEN_UART_IOCTL_POLL_MODE:
+            status = LocPollSet(chanP, (u_int32)arg);
             break;
 
-        case MEN_UART_IOCTL_SET_FIFO_BYTES:
-            status = MZ25_SetFifoTriggerLevel(chanP->unitHdlP, 0, arg);
+        case MEN_UART_IOCTL_RX_TIMESTAMP:
+            chanP->rxStampOn = (arg != 0) ? TRUE : FALSE;
             break;
 
-        case MEN_UART_IOCTL_SET_TX_FIFO_BYTES:
-            status = MZ25_SetFifoTriggerLevel(chanP->unitHdlP, 1, arg);
+        case MEN_UART_IOCTL_GET_RX_TIMESTAMP:
+            {
+                int lockKey = intLock();
+                *(MEN_UART_RX_TIMESTAMP *)pArg = chanP->rxStamp;
+                intUnlock(lockKey);
+            }
             break;
 
-        case MEN_UART_IOCTL_LINE_STATUS:
-            status = MZ25_GetLineStatus(chanP->unitHdlP);
+        case MEN_UART_IOCTL_STATS:
+            chanP->statsOn = (arg != 0) ? TRUE : FALSE;
             break;
 
-        case MEN_UART_IOCTL_RTS_CTS:
-            if( arg == 1 ){
-                status = MZ25_EnableAutoRtsCts(chanP->unitHdlP, TRUE);
-            }
-            else {
-                status = MZ25_EnableAutoRtsCts(chanP->unitHdlP, FALSE);
+        case MEN_UART_IOCTL_GET_STATS:
+            {
+                int lockKey = intLock();
+                *(MEN_UART_STATS *)pArg = chanP->stats;
+                intUnlock(lockKey);
             }
             break;
 
-        case MEN_UART_IOCTL_HANDSHAKE_OFF:
-            status = MZ25_EnableAutoRtsCts(chanP->unitHdlP, FALSE);
+        case MEN_UART_IOCTL_CLEAR_STATS:
+            {
+                int lockKey = intLock();
+                bzero((char *)&chanP->stats, sizeof(MEN_UART_STATS));
+                intUnlock(lockKey);
+            }
             break;
 
         default:
@@ -1852,20 +5470,69 @@ LOCAL int LocIoctl(Z25_TY_CO_DEV_TS *chanP,
  *  This routine is used by the VxWorks tyLib to enable the Tx
  *  interrupt. It is called once for each send cycle. If transmission
  *  finished the transmit interrupt must be disabled by the transmit
- *  interrupt routine.
+ *  interrupt routine. If the transmitter is idle, the first FIFO-full
+ *  is written directly, which saves the THRE interrupt round trip. The
+ *  FIFO is filled before the Tx interrupt is enabled, on SMP the ISR
+ *  may run on another CPU and must not fill it at the same time.
  *
  *  \param chanP            channel that caused the interrupt
  *
  *  \return not return value
  */
 LOCAL void LocStartup( Z25_TY_CO_DEV_TS *chanP ){
+    /* poll mode: LocPoll transmits */
+    if( chanP->pollTicks > 0 ){
+        return;
+    }
+
+    /* Modbus RTU: keep the inter-frame gap before transmitting */
+    if( (chanP->created == LZ25_CREATE_TYPE_LATE) &&
+        (chanP->framerP != NULL) &&
+        (chanP->framerP->cfg.mode == MEN_UART_FRAMER_MODBUS_RTU) ){
+        int32 delay = (int32)(chanP->framerP->idleTick - tickGet());
+
+        if( delay > 0 ){
+            wdStart(chanP->framerP->txWd, (int)delay,
+                    (FUNCPTR)LocStartup, (int)chanP);
+            return;
+        }
+    }
+
+    /* SIO polled mode: the caller uses pollOutput */
+    if( (chanP->created == LZ25_CREATE_TYPE_AT_BOOT) &&
+        (chanP->u.sioT.mode == SIO_MODE_POLL) ){
+        return;
+    }
+
     /* CTS initial state check */
-    if( MZ25_GetModemControl(chanP->unitHdlP) == TRUE ){
+    if( chanP->uartUnit.modemControl == TRUE ){
         MZ25_ControlModemTxInt(chanP->unitHdlP);
     }
     else{
+        int lockKey;
+
+        /* the ISR of this CPU must not serve the channel meanwhile */
+        lockKey = intLock();
+
+        /*
+         * transmitter idle: fill the FIFO now instead of waiting for the
+         * THRE interrupt, the interrupt continues with the rest. With
+         * THREIEN still clear no ISR transmits on another CPU.
+         */
+        if( !(MZ25_REG_READ(chanP->addr, MIZ25_IER_OFFSET) & MZ25_THREIEN) &&
+            (MZ25_LINE_STATUS(chanP->addr) & MIZ25_THEP) ){
+            if( chanP->created == LZ25_CREATE_TYPE_LATE ){
+                LocTyTransmitInt(chanP);
+            }
+            else if( chanP->created == LZ25_CREATE_TYPE_AT_BOOT ){
+                LocSioTransmitInt(chanP);
+            }
+        }
+
         /* enable Tx interrupt */
         MZ25_EnableInterrupt(chanP->unitHdlP, MZ25_THREIEN);
+
+        intUnlock(lockKey);
     }
 }/* LocStartup */
 
@@ -1880,7 +5547,7 @@ LOCAL void LocStartup( Z25_TY_CO_DEV_TS *chanP ){
  *  \return no return value
  */
 LOCAL void LocLineInt(Z25_TY_CO_DEV_TS *chanP){
-    IDBGWRT_4((((TS_16Z25_UNIT *)chanP->unitHdlP)->dbgHdlP,
+    IDBGWRT_4((chanP->uartUnit.dbgHdlP,
         ">>> Z25/Z125 - LocLineInt\n"));
     MZ25_SetLineStatus(chanP->unitHdlP);
 }/* LocLineInt */
@@ -1896,16 +5563,69 @@ LOCAL void LocLineInt(Z25_TY_CO_DEV_TS *chanP){
  */
 LOCAL void LocTyReceiveInt(Z25_TY_CO_DEV_TS *chanP){
     u_int8 inByte = 0;  /* received byte */
-
-
-    IDBGWRT_4((((TS_16Z25_UNIT *)chanP->unitHdlP)->dbgHdlP,
+    u_int8 lineStatus;  /* line status register */
+    u_int32 noBytes = 0;
+    u_int32 noDropped = 0;
+    u_int32 noOverruns = 0;
+    Z25_FRAMER_TS *framerP = chanP->framerP;
+    Z25_BOND_TS *bondP = chanP->bondP;
+    u_int8 rxBuf[IZ25_SIO_BLOCK_SIZE];  /* burst for the framer/bond */
+    u_int32 noBuf = 0;
+
+    IDBGWRT_4((chanP->uartUnit.dbgHdlP,
         ">>> Z25/Z125 - LocTyReceiveInt\n"));
 
-    while(MZ25_RECEIVE_STATUS(chanP->addr))
+    if( chanP->rxStampOn ){
+        chanP->rxStamp.tick = tickGet();
+#ifdef INCLUDE_TIMESTAMP
+        chanP->rxStamp.stamp = sysTimestamp();
+#endif
+    }
+
+    while( (lineStatus = MZ25_LINE_STATUS(chanP->addr)) & MIZ25_DR )
     {
         inByte = MZ25_READ_BYTE(chanP->addr);
 
-        tyIRd (&chanP->u.tyDev, (char)inByte );
+        if( chanP->transP != NULL ){
+            LocTransRx(chanP, chanP->transP, inByte);
+        }
+        else if( bondP != NULL ){
+            rxBuf[noBuf++] = inByte;
+            if( noBuf == IZ25_SIO_BLOCK_SIZE ){
+                LocBondRx(chanP, bondP, rxBuf, noBuf);
+                noBuf = 0;
+            }
+        }
+        else if( framerP != NULL ){
+            rxBuf[noBuf++] = inByte;
+            if( noBuf == IZ25_SIO_BLOCK_SIZE ){
+                LocFramerRx(chanP, framerP, rxBuf, noBuf);
+                noBuf = 0;
+            }
+        }
+        else if( tyIRd (&chanP->u.tyDev, (char)inByte ) != OK ){
+            noDropped++;
+        }
+        if( lineStatus & MIZ25_OE ){
+            noOverruns++;
+        }
+        noBytes++;
+    }
+
+    if( noBuf > 0 ){
+        if( bondP != NULL ){
+            LocBondRx(chanP, bondP, rxBuf, noBuf);
+        }
+        else {
+            LocFramerRx(chanP, framerP, rxBuf, noBuf);
+        }
+    }
+
+    if( chanP->statsOn && (noBytes > 0) ){
+        chanP->stats.rxBytes    += noBytes;
+        chanP->stats.rxDropped  += noDropped;
+        chanP->stats.rxOverruns += noOverruns;
+        chanP->stats.rxBursts++;
     }
 }/* LocTyReceiveInt */
 
@@ -1921,9 +5641,29 @@ LOCAL void LocTyReceiveInt(Z25_TY_CO_DEV_TS *chanP){
 LOCAL void LocSioReceiveInt(Z25_TY_CO_DEV_TS *chanP){
     u_int8 inByte = 0;  /* received byte */
 
-    IDBGWRT_4((((TS_16Z25_UNIT *)chanP->unitHdlP)->dbgHdlP,
+    IDBGWRT_4((chanP->uartUnit.dbgHdlP,
         ">>> Z25/Z125 - LocSioReceiveInt\n"));
 
+    /* hand over the whole burst */
+    if( chanP->u.sioT.putRcvBlock != NULL ){
+        u_int8 rxBuf[IZ25_SIO_BLOCK_SIZE];
+        int len = 0;
+
+        while(MZ25_RECEIVE_STATUS(chanP->addr)){
+            rxBuf[len++] = MZ25_READ_BYTE(chanP->addr);
+            if( len == IZ25_SIO_BLOCK_SIZE ){
+                (*chanP->u.sioT.putRcvBlock)
+                    ( chanP->u.sioT.putRcvBlockArg, rxBuf, len );
+                len = 0;
+            }
+        }
+        if( len > 0 ){
+            (*chanP->u.sioT.putRcvBlock)
+                ( chanP->u.sioT.putRcvBlockArg, rxBuf, len );
+        }
+        return;
+    }
+
 	/* don't know how to handle characters?
 	 * throw them away! */
     if( chanP->u.sioT.putRcvChar == NULL ){
@@ -1955,22 +5695,58 @@ LOCAL void LocTyTransmitInt(Z25_TY_CO_DEV_TS *chanP){
     u_int8 fifoBytes = 0;   /* FIFO size */
 
     fifoBytes =
-        ((TS_16Z25_UNIT *)chanP->unitHdlP)->fifoTxTrigger;
+        chanP->uartUnit.fifoTxTrigger;
 
-    IDBGWRT_4((((TS_16Z25_UNIT *)chanP->unitHdlP)->dbgHdlP,
+    IDBGWRT_4((chanP->uartUnit.dbgHdlP,
         ">>> Z25/Z125 - LocTyTransmitInt: fifoBytes = %d\n", fifoBytes));
 
-    while( fifoBytes-- ){
+    /* urgent messages first, then the time scheduled message */
+    fifoBytes -= LocUrgentTx(chanP, fifoBytes);
+    fifoBytes -= LocTimedTx(chanP, fifoBytes);
+
+    /* finish a started descriptor, tyLib data must not split it */
+    if( (chanP->txDescQP != NULL) && (chanP->txDescQP->offset > 0) ){
+        Z25_TX_DESC_Q_TS *qP = chanP->txDescQP;
+        u_int32 rest = qP->descP[qP->head % IZ25_TX_DESC_MAX]->len -
+                       qP->offset;
+
+        fifoBytes -= LocTxDescTx(chanP, qP,
+                        (rest < fifoBytes) ? (u_int8)rest : fifoBytes);
+    }
+
+    while( fifoBytes ){
         if( tyITx(&chanP->u.tyDev, &outByte) == OK ){
             /* fill output FIFO */
             MZ25_WRITE_BYTE(chanP->addr, outByte);
+            fifoBytes--;
         }
         else{
+            /* tyLib buffer empty, continue with caller owned buffers */
+            if( (chanP->txDescQP != NULL) &&
+                (chanP->txDescQP->head != chanP->txDescQP->tail) ){
+                fifoBytes -= LocTxDescTx(chanP, chanP->txDescQP, fifoBytes);
+                break;
+            }
+
             /* disable Tx interrupt - transmission finished */
-            MZ25_DisableInterrupt(chanP->unitHdlP, MZ25_THREIEN);
-            return;
+            if( chanP->pollTicks == 0 ){
+                MZ25_DisableInterrupt(chanP->unitHdlP, MZ25_THREIEN);
+            }
+            /* Modbus RTU: gap after the bytes still in the FIFO */
+            if( (chanP->framerP != NULL) &&
+                (chanP->framerP->cfg.mode == MEN_UART_FRAMER_MODBUS_RTU) ){
+                chanP->framerP->idleTick = tickGet() +
+                    LocFramerTicks(chanP, IZ25_RTU_GAP_BITS +
+                        (chanP->uartUnit.fifoTxTrigger - fifoBytes) * 11);
+            }
+            break;
         }
     }/*while*/
+
+    if( chanP->statsOn && (fifoBytes < chanP->uartUnit.fifoTxTrigger) ){
+        chanP->stats.txBytes += chanP->uartUnit.fifoTxTrigger - fifoBytes;
+        chanP->stats.txBursts++;
+    }
 }/* LocTyTransmitInt */
 
 /**********************************************************************/
@@ -1986,14 +5762,41 @@ LOCAL void LocSioTransmitInt(Z25_TY_CO_DEV_TS *chanP){
     u_int8 outByte = 0;     /* byte to transmit */
     u_int8 fifoBytes = 0;   /* FIFO size */
 
-    if( chanP->u.sioT.getTxChar == NULL ){
+    fifoBytes =
+    chanP->uartUnit.fifoTxTrigger;
+
+    /* urgent messages first */
+    if( (fifoBytes -= LocUrgentTx(chanP, fifoBytes)) == 0 ){
         return;
     }
 
-    fifoBytes =
-    ((TS_16Z25_UNIT *)chanP->unitHdlP)->fifoTxTrigger;
+    /* fetch the whole burst */
+    if( chanP->u.sioT.getTxBlock != NULL ){
+        u_int8 txBuf[IZ25_SIO_BLOCK_SIZE];
+        int len, i;
+
+        len = (*chanP->u.sioT.getTxBlock)
+                  ( chanP->u.sioT.getTxBlockArg, txBuf,
+                    (fifoBytes < IZ25_SIO_BLOCK_SIZE) ?
+                     fifoBytes : IZ25_SIO_BLOCK_SIZE );
+        if( len <= 0 ){
+            /* disable Tx interrupt - transmission finished */
+            MZ25_DisableInterrupt(chanP->unitHdlP, MZ25_THREIEN);
+            return;
+        }
+        for( i=0; i<len; i++ ){
+            MZ25_WRITE_BYTE(chanP->addr, txBuf[i]);
+        }
+        return;
+    }
+
+    if( chanP->u.sioT.getTxChar == NULL ){
+        /* urgent data only */
+        MZ25_DisableInterrupt(chanP->unitHdlP, MZ25_THREIEN);
+        return;
+    }
 
-    IDBGWRT_4((((TS_16Z25_UNIT *)chanP->unitHdlP)->dbgHdlP,
+    IDBGWRT_4((chanP->uartUnit.dbgHdlP,
     ">>> Z25/Z125 - LocSioTransmitInt: fifoBytes = %d\n", fifoBytes));
 
     while (fifoBytes--){
@@ -2024,31 +5827,74 @@ LOCAL void LocModemInt(Z25_TY_CO_DEV_TS *chanP){
     MZ25_ControlModemTxInt(chanP->unitHdlP);
 }/* LocModemInt */
 
+/**********************************************************************/
+/** Routine to serve a tty channel in poll mode
+ *
+ *  This routine is started by the poll watchdog of the channel (see
+ *  LocPollSet). It does the work of the receive and transmit interrupts
+ *  depending on the line status and restarts the watchdog.
+ *
+ *  \param chanP            channel to serve
+ *
+ *  \return no return value
+ */
+LOCAL void LocPoll(Z25_TY_CO_DEV_TS *chanP){
+    u_int8 lineStatus;
+
+    if( chanP->pollTicks == 0 ){
+        return;
+    }
+
+    lineStatus = MZ25_LINE_STATUS(chanP->addr);
+
+    if( lineStatus & MIZ25_DR ){
+        LocTyReceiveInt(chanP);
+    }
+
+    /* a poll period without data is the frame gap */
+    if( chanP->framerP != NULL ){
+        LocFramerRxEnd(chanP, !(lineStatus & MIZ25_DR));
+    }
+
+    if( lineStatus & MIZ25_THEP ){
+        LocTyTransmitInt(chanP);
+    }
+
+    wdStart(chanP->pollWd, (int)chanP->pollTicks, (FUNCPTR)LocPoll, (int)chanP);
+}/* LocPoll */
+
 /**********************************************************************/
 /** Routine to handle the 16Z025/16Z125 and 16Z057 interrupts
  *
  *  This routine is the low-level interrupt routine. It is used to serve
  *  the interrupts for the different sources, e.g. receive IRQ,
- *  modem IRQ ... .
+ *  modem IRQ ... . The channel structure is only accessed if the
+ *  interrupt belongs to the channel.
  *
- *  \param chanP            channel that caused the interrupt
+ *  \param isrChanP         channel entry of the ISR descriptor
  *
  *  \return no return value
  */
-LOCAL void LocInterruptRoutine(Z25_TY_CO_DEV_TS *chanP){
+LOCAL void LocInterruptRoutine(Z25_ISR_CHAN_TS *isrChanP){
     u_int8 interruptIdent = 0;      /* interrupt ID */
+    Z25_TY_CO_DEV_TS *chanP;        /* channel structure */
 
-    interruptIdent = MZ25_IRQ_IDENT(chanP->addr);
+    if( isrChanP->addr == 0 ){
+        return;
+    }
+
+    interruptIdent = MZ25_IRQ_IDENT(isrChanP->addr);
 
     if( interruptIdent & MIZ25_IRQN ) {
-        IDBGWRT_3((((TS_16Z25_UNIT *)chanP->unitHdlP)->dbgHdlP,
+        IDBGWRT_3((isrChanP->chanP->uartUnit.dbgHdlP,
             ">>> Z25/Z125 - LocInterruptRoutine IRQ not mine\n"));
         return;
     }
 
     interruptIdent &= ~MIZ25_IRQN; /* we know now that is ours */
+    chanP = isrChanP->chanP;
 
-    IDBGWRT_4((((TS_16Z25_UNIT *)chanP->unitHdlP)->dbgHdlP,
+    IDBGWRT_4((chanP->uartUnit.dbgHdlP,
         ">>> Z25/Z125 - LocInterruptRoutine irqId=0x%08x\n", interruptIdent));
 
     if( (interruptIdent == MZ25_RCV_LINE_STATUS) ){
@@ -2059,10 +5905,14 @@ LOCAL void LocInterruptRoutine(Z25_TY_CO_DEV_TS *chanP){
         (interruptIdent == MZ25_CHAR_TIMEOUT) )
     {
 
-        if( chanP->created == LZ25_CREATE_TYPE_LATE ){
+        if( isrChanP->created == LZ25_CREATE_TYPE_LATE ){
             LocTyReceiveInt(chanP);
+            if( chanP->framerP != NULL ){
+                LocFramerRxEnd(chanP,
+                               (interruptIdent == MZ25_CHAR_TIMEOUT));
+            }
         }
-        else if( chanP->created == LZ25_CREATE_TYPE_AT_BOOT ){
+        else if( isrChanP->created == LZ25_CREATE_TYPE_AT_BOOT ){
             LocSioReceiveInt(chanP);
         }
     }
@@ -2070,10 +5920,10 @@ LOCAL void LocInterruptRoutine(Z25_TY_CO_DEV_TS *chanP){
     /* transmitter holding register empty */
     if( (interruptIdent == MZ25_THR_REG_EMPTY) ){
 
-        if( chanP->created == LZ25_CREATE_TYPE_LATE ){
+        if( isrChanP->created == LZ25_CREATE_TYPE_LATE ){
             LocTyTransmitInt(chanP);
         }
-        else if( chanP->created == LZ25_CREATE_TYPE_AT_BOOT ){
+        else if( isrChanP->created == LZ25_CREATE_TYPE_AT_BOOT ){
             LocSioTransmitInt(chanP);
         }
     }
@@ -2089,42 +5939,42 @@ LOCAL void LocInterruptRoutine(Z25_TY_CO_DEV_TS *chanP){
  *  This routine does the global interrupt proccessing and calls the
  *  LocInterruptRoutine function with the correct channel.
  *
- *  \param chanP            channel structure
+ *  \param isrP             ISR descriptor of the unit
  *
  *  \return no return value
  */
-LOCAL void LocInterrupt(Z25_TY_CO_DEV_TS *chanP){
+LOCAL void LocInterrupt(Z25_ISR_UNIT_TS *isrP){
 
-    if( chanP->uartCore == IZ25_MODID_2){
-        LocInterruptRoutine(chanP);
+    if( isrP->uartCore == IZ25_MODID_2){
+        LocInterruptRoutine(&isrP->chan[0]);
     }
     else {
         u_int8 interruptSource = 0;     /* interrupt source */
 
         /* read out global interrupt register, to detect which
            UART channel caused the interrupt */
-        interruptSource = MZ25_UART_INTERRUPT(chanP->baseAddr);
+        interruptSource = MZ25_UART_INTERRUPT(isrP->baseAddr);
 
         /* UART 0..3 interrupt ? */
         if( interruptSource > 0x00 ){   /* yes */
             if( (interruptSource&MZ25_U1_IRQ) == MZ25_U1_IRQ ){
                 /* channel 0 interrupt handling */
-                LocInterruptRoutine(chanP);
+                LocInterruptRoutine(&isrP->chan[0]);
             }
 
             if( (interruptSource&MZ25_U2_IRQ) == MZ25_U2_IRQ ){
                 /* channel 1 interrupt handling */
-                LocInterruptRoutine((chanP+1));
+                LocInterruptRoutine(&isrP->chan[1]);
             }
 
             if( (interruptSource&MZ25_U3_IRQ) == MZ25_U3_IRQ ){
                 /* channel 2 interrupt handling */
-                LocInterruptRoutine((chanP+2));
+                LocInterruptRoutine(&isrP->chan[2]);
             }
 
             if( (interruptSource&MZ25_U4_IRQ) == MZ25_U4_IRQ ){
                 /* channel 3 interrupt handling */
-                LocInterruptRoutine((chanP+3));
+                LocInterruptRoutine(&isrP->chan[3]);
             }
         }
     }
@@ -2159,12 +6009,107 @@ LOCAL STATUS LocInitHandle(Z25_HDL **hdlP){
     return Z25_OK;
 }/* LocInitHandle */
 
+/**********************************************************************/
+/** Routine to lock the shared driver handle
+ *
+ *  This routine takes the mutex which protects the shared handle and its
+ *  reference count. The mutex is created at the first call.
+ *
+ *  \return Z25_OK or Z25_ERROR
+ */
+LOCAL STATUS LocSharedLock(void){
+    if( G_Z25_SharedSemId == NULL ){
+        taskLock();
+        if( G_Z25_SharedSemId == NULL ){
+            G_Z25_SharedSemId = semMCreate( SEM_Q_PRIORITY |
+                                            SEM_DELETE_SAFE |
+                                            SEM_INVERSION_SAFE );
+        }
+        taskUnlock();
+
+        if( G_Z25_SharedSemId == NULL ){
+            return Z25_ERROR;
+        }
+    }
+
+    return semTake(G_Z25_SharedSemId, WAIT_FOREVER);
+}/* LocSharedLock */
+
+/**********************************************************************/
+/** Routine to unlock the shared driver handle
+ *
+ *  \return no return value
+ */
+LOCAL void LocSharedUnlock(void){
+    semGive(G_Z25_SharedSemId);
+}/* LocSharedUnlock */
+
+/**********************************************************************/
+/** Routine to lock a channel
+ *
+ *  This routine takes the mutex of a channel. It serializes the bring up
+ *  at the first open and the allocation of the channel resources,
+ *  without blocking other channels on the shared handle mutex.
+ *
+ *  \param chanP        channel structure
+ *
+ *  \return OK or ERROR
+ */
+LOCAL STATUS LocChanLock( Z25_TY_CO_DEV_TS *chanP ){
+    return semTake(chanP->chanSem, WAIT_FOREVER);
+}/* LocChanLock */
+
+/**********************************************************************/
+/** Routine to unlock a channel
+ *
+ *  \param chanP        channel structure
+ *
+ *  \return no return value
+ */
+LOCAL void LocChanUnlock( Z25_TY_CO_DEV_TS *chanP ){
+    semGive(chanP->chanSem);
+}/* LocChanUnlock */
+
+/**********************************************************************/
+/** Routine to get a channel resource, created at its first use
+ *
+ *  Resources needed by single io controls only (transaction, Tx
+ *  descriptors, urgent and scheduled messages) are created when they
+ *  are used first. The creation is serialized by the channel mutex, the
+ *  resource is stored once it is complete.
+ *
+ *  \param chanP            channel structure
+ *  \param resPP            resource pointer in the channel structure
+ *  \param createFct        creates the resource, returns NULL if error
+ *
+ *  \return resource or NULL if error
+ */
+LOCAL void *LocChanResGet( Z25_TY_CO_DEV_TS *chanP,
+                           void **resPP,
+                           void *(*createFct)(Z25_TY_CO_DEV_TS *chanP) ){
+    if( *resPP == NULL ){
+        if( LocChanLock(chanP) != OK ){
+            return NULL;
+        }
+        if( *resPP == NULL ){
+            *resPP = (*createFct)(chanP);
+        }
+        LocChanUnlock(chanP);
+    }
+
+    return *resPP;
+}/* LocChanResGet */
+
 /**********************************************************************/
 /** Routine to initialize UART channels
  *
- *  This routine initializes a UART channel to its default values. It must
+ *  This routine sets a UART channel to its default values. It must
  *  be called for each channel.
  *
+ *  The defaults are only stored in the 16Z025 handle of the channel.
+ *  Boot time channels are programmed at once, tty channels are programmed
+ *  by LocBringUpChannel() at their first open.
+ *
  *  \param hdlP         Z25 handle returned by Z25_Init
  *  \param unit         quad UART unit to connect and enable interrupt
  *  \param channel      channel number
@@ -2177,7 +6122,8 @@ LOCAL STATUS LocInitChannels(Z25_HDL *hdlP,
                            u_int16 channel,
                            u_int8 createType ){
     Z25_DEV_TS *z25DevP;  /* Z25 resources */
-    HDL_16Z25 *unitHdlP;   /* 16Z025 handle */
+    Z25_TY_CO_DEV_TS *chanP;    /* channel */
+    TS_16Z25_UNIT *unitP;       /* 16Z025 state */
 
     if( hdlP == NULL ){
         return Z25_ERROR;
@@ -2186,37 +6132,41 @@ LOCAL STATUS LocInitChannels(Z25_HDL *hdlP,
         z25DevP = hdlP;
     }
 
-    unitHdlP = (HDL_16Z25 *)z25DevP->quadUart[unit][channel].unitHdlP;
+    chanP = &z25DevP->quadUart[unit][channel];
+    unitP = &chanP->uartUnit;
 
     DBGWRT_2((z25DevP->dbgHdlP,
         "Z25/Z125 - channel %d (%d.unit) initialization (address=0x%x, irq=0x%x)\n",
         channel,
         (unit+1),
-        z25DevP->quadUart[unit][channel].addr,
-        (u_int8)z25DevP->quadUart[unit][channel].irq));
-
-    /* disable all interrupts */
-    MZ25_DisableInterrupt(unitHdlP, 0);
-
-    /* /\* set UART to RS232 mode as default *\/  ts: moved to LocOpen() */
-    /* MZ25_SetSerialMode(unitHdlP, MZ25_MODE_RS232); */
-
-    /* set baudrate */
-    MZ25_SetSerialParameter(unitHdlP,
-        (MZ25_DATABITS_8 | MZ25_STOPBITS_1 | MZ25_NO_PARITY));
-
-    MZ25_SetBaudrate(unitHdlP, Z25_DEFAULT_BAUDRATE);
-
-    /* enable FIFO, set initial FIFO trigger level to 4 bytes */
-    MZ25_SetFifoTriggerLevel(unitHdlP, 0, Z25_RX_FIFO_TRIG_LEVEL);  /* rx trigger level */
-    MZ25_SetFifoTriggerLevel(unitHdlP, 1, Z25_TX_FIFO_TRIG_LEVEL);  /* tx trigger level */
-
-    MZ25_SetRts(unitHdlP, TRUE);
-    MZ25_SetDtr(unitHdlP, TRUE);
-    MZ25_SetOut1(unitHdlP, FALSE);
-    MZ25_SetOut2(unitHdlP, FALSE);
-
-    z25DevP->quadUart[unit][channel].created  = createType;
+        chanP->addr,
+        (u_int8)chanP->irq));
+
+    /* 8N1, default baudrate */
+    unitP->stopbits = MZ25_STOPBITS_1;
+    unitP->databits = MZ25_DATABITS_8;
+    unitP->parity   = MZ25_NO_PARITY;
+    unitP->baudrate = Z25_DEFAULT_BAUDRATE;
+
+    /* initial FIFO trigger levels */
+    unitP->fifoRxTrigger = Z25_RX_FIFO_TRIG_LEVEL;
+    unitP->fifoTxTrigger = Z25_TX_FIFO_TRIG_LEVEL;
+
+    unitP->rts  = TRUE;
+    unitP->dtr  = TRUE;
+    unitP->out1 = FALSE;
+    unitP->out2 = FALSE;
+
+    chanP->devHdlP = z25DevP;
+    chanP->unitIdx = unit;
+    chanP->created = createType;
+    z25DevP->isrUnitP[unit]->chan[channel].created = createType;
+
+    if( createType == LZ25_CREATE_TYPE_AT_BOOT ){
+        /* the SIO console is used before any open */
+        MZ25_RestoreUnit(chanP->unitHdlP);
+        chanP->hwInit = TRUE;
+    }
 
     return Z25_OK;
 }/* LocInitChannels */
@@ -2237,6 +6187,9 @@ LOCAL STATUS LocEnableInterrupt(Z25_HDL *hdlP,
                           		 u_int16 unit,
                          		 u_int16 channel){
     Z25_DEV_TS *z25DevP;  /* Z25 resources */
+    Z25_ISR_UNIT_TS *isrP;  /* ISR descriptor of unit */
+    VXB_DEVICE_ID vxbDevID = G_Z25_vxbDevID;  /* PCI controller of unit */
+    u_int16 i;
 
     if( hdlP == NULL ){
         return Z25_ERROR;
@@ -2245,23 +6198,53 @@ LOCAL STATUS LocEnableInterrupt(Z25_HDL *hdlP,
         z25DevP = hdlP;
     }
 
+    /* PCI controller of the domain the unit resides in */
+    for( i=0; i<z25DevP->noPciPaths; i++ ){
+        if( (unit >= z25DevP->pathInfo[i].start16Z25Unit) &&
+            (unit < z25DevP->pathInfo[i].start16Z25Unit +
+                    z25DevP->pathInfo[i].no16Z25Units) ){
+            if( z25DevP->pathInfo[i].pci.vxbDevID != NULL ){
+                vxbDevID = z25DevP->pathInfo[i].pci.vxbDevID;
+            }
+            break;
+        }
+    }
+
     DBGWRT_1((z25DevP->dbgHdlP,
         "Z25/Z125 - LocEnableInterrupt unit %d, channel %d (address=0x%lx, irq=0x%x)\n",
         unit, channel,
         z25DevP->quadUart[unit][0].addr,
         z25DevP->quadUart[unit][0].irq));
 
-	/* Connect.. */
-    (*z25DevP->irqFct.fIntConnectP)(
+    /* the ISR serves all channels of the unit, connect it only once */
+    isrP = z25DevP->isrUnitP[unit];
+    if( semTake(isrP->connectSem, WAIT_FOREVER) != OK ){
+        return Z25_ERROR;
+    }
+    if( !isrP->connected ){
+        /* channels not opened yet must not raise the shared interrupt */
+        for( i=0; i<isrP->noChan; i++ ){
+            if( (isrP->chan[i].addr != 0) &&
+                !z25DevP->quadUart[unit][i].hwInit ){
+                MZ25_DisableInterrupt(
+                    (HDL_16Z25 *)z25DevP->quadUart[unit][i].unitHdlP, 0);
+            }
+        }
+
+        /* Connect.. */
+        (*z25DevP->irqFct.fIntConnectP)(
 #ifdef Z25_USE_VXBPCI_FUNCS
-    (VXB_DEVICE_ID)(G_Z25_vxbDevID),
+        vxbDevID,
 #endif
-    (VOIDFUNCPTR*) INUM_TO_IVEC(INT_NUM_GET((int)z25DevP->quadUart[unit][0].irqvec)),
-    (VOIDFUNCPTR)  LocInterrupt,
-    (int)          &z25DevP->quadUart[unit][0] );
+        (VOIDFUNCPTR*) INUM_TO_IVEC(INT_NUM_GET((int)z25DevP->quadUart[unit][0].irqvec)),
+        (VOIDFUNCPTR)  LocInterrupt,
+        (int)          isrP );
 
-    /* ..and enable the IRQ */
-    (*z25DevP->irqFct.fIntEnableP)(z25DevP->quadUart[unit][0].irq);
+        /* ..and enable the IRQ */
+        (*z25DevP->irqFct.fIntEnableP)(z25DevP->quadUart[unit][0].irq);
+        isrP->connected = TRUE;
+    }
+    semGive(isrP->connectSem);
 
     /* enable receive interrupt of channel */
     MZ25_EnableInterrupt( (HDL_16Z25 *)z25DevP->quadUart[unit][channel].unitHdlP,
@@ -2270,6 +6253,56 @@ LOCAL STATUS LocEnableInterrupt(Z25_HDL *hdlP,
     return Z25_OK;
 } /* LocEnableInterrupt */
 
+/**********************************************************************/
+/** Routine to bring up a tty channel
+ *
+ *  This routine programs the UART registers from the settings stored
+ *  in the 16Z025 handle and enables the interrupt of the channel. It is
+ *  called at the first open of a channel, unused channels are never
+ *  touched.
+ *
+ *  \param chanP        channel structure
+ *
+ *  \return Z25_OK or Z25_ERROR
+ */
+LOCAL STATUS LocBringUpChannel( Z25_TY_CO_DEV_TS *chanP )
+{
+    STATUS error = Z25_OK;
+
+    /* concurrent first opens of the channel */
+    if( LocChanLock(chanP) != OK ){
+        return Z25_ERROR;
+    }
+
+    if( !chanP->hwInit ){
+        DBGWRT_2((chanP->dbgHdlP,
+            "Z25/Z125 - bring up channel %d (%d.unit)\n",
+            chanP->unit, chanP->unitIdx + 1));
+
+        MZ25_RestoreUnit(chanP->unitHdlP);
+        if( chanP->pollTicks > 0 ){
+            /* poll mode, interrupts of the channel stay disabled */
+            wdStart(chanP->pollWd, (int)chanP->pollTicks,
+                    (FUNCPTR)LocPoll, (int)chanP);
+        }
+        else {
+            error = LocEnableInterrupt(chanP->devHdlP, chanP->unitIdx,
+                                       chanP->unit);
+            /* e.g. DTR/DSR flow control set before the first open */
+            if( (error == Z25_OK) &&
+                (chanP->uartUnit.modemControl == TRUE) ){
+                MZ25_SetModemControl(chanP->unitHdlP, TRUE);
+            }
+        }
+        if( error == Z25_OK ){
+            chanP->hwInit = TRUE;
+        }
+    }
+
+    LocChanUnlock(chanP);
+    return error;
+}/* LocBringUpChannel */
+
 /**********************************************************************/
 /** Routine to convert a string to hexadecimal values
  *
@@ -2328,7 +6361,8 @@ void Z25_DriverId(void){
  *
  *  This routine does the complete procedure to find the 16Z025/16Z125
  *  and 16Z057 UART units and to initialize them. It calls the necessary
- *  subroutines.
+ *  subroutines. The Chameleon table of the path is parsed only once,
+ *  the units are taken from its index.
  *
  *  \param hdlP         Z25 handle returned by Z25_Init
  *  \param pathIndex    index of PCI path in its array
@@ -2341,134 +6375,97 @@ STATUS Z25_FindUartUnits(Z25_HDL *hdlP,
                           u_int16 pathIndex,
                           u_int16 *unitP,
                           u_int16 *maxUnitsP){
+    IZ25_PROF_DECL
     Z25_DEV_TS *z25HdlP;      			/* Z25 resources */
-    CHAM_FUNCTBL        chamFctTable;   /* Chameleon function table */
-    CHAMELEONV2_HANDLE *chamHdl;        /* Chameleon handle */
-	CHAMELEONV2_FIND	chamFind;       /* Chameleon find */
-	CHAMELEONV2_UNIT    chamInfo;       /* Chameleon unit information */
-    u_int16 i;                          /* for loop index */
-    u_int16 k = 0;                      /* while loop index */
+    Z25_PATH_TS *pathP;                 /* PCI path */
+    Z25_CHAM_UNIT_TS *chamUnitP;        /* indexed Chameleon unit */
+    u_int16 k;                          /* module id index */
+    u_int16 idx;                        /* instance index per module */
     u_int16 unit = 0;                   /* UART unit counter */
     int32 irq = 0;                     	/* UART unit interrupt */
 
     if( hdlP == NULL ){
-        return Z25_ERROR;
+        IZ25_PROF_RETURN(IZ25_PROF_FIND_UNITS, Z25_ERROR);
     }
     else{
         z25HdlP = hdlP;
     }
 
-    i = pathIndex;
+    if( pathIndex >= z25HdlP->noPciPaths ){
+        IZ25_PROF_RETURN(IZ25_PROF_FIND_UNITS, Z25_ERROR);
+    }
+
+    pathP = &z25HdlP->pathInfo[pathIndex];
+
+    /* units of this path already found by a previous call */
+    if( pathP->no16Z25Units > 0 ){
+        *unitP = pathP->start16Z25Unit;
+        *maxUnitsP = pathP->no16Z25Units;
+        IZ25_PROF_RETURN(IZ25_PROF_FIND_UNITS, Z25_OK);
+    }
 
     DBGWRT_1((z25HdlP->dbgHdlP, "Z25_FindUartUnits: pathIndex = %d @ PCI dom./b.d.f %d/%d.%d.%d\n",
     		pathIndex,
-    		OSS_DOMAIN_NBR(z25HdlP->pathInfo[i].pci.bus),
-			OSS_BUS_NBR(z25HdlP->pathInfo[i].pci.bus),
-			z25HdlP->pathInfo[i].pci.dev,
-			z25HdlP->pathInfo[i].pci.fct ));
+    		OSS_DOMAIN_NBR(pathP->pci.bus),
+			OSS_BUS_NBR(pathP->pci.bus),
+			pathP->pci.dev,
+			pathP->pci.fct ));
 
-    if( CHAM_INIT(&chamFctTable) != CHAMELEON_OK ){
-        DBGWRT_ERR( (z25HdlP->dbgHdlP,
-            "*** Z25/Z125 - Chameleon V2 initialization failed.\n") );
-        return Z25_ERROR;
-    }
-    /* when the MDIS project for the CPU on which this driver runs
-     * is compiled with OSS_VXBUS_SUPPORT then the PCI domain which should be
-     * merged into the upper 16bit of bus nr. are evaluated as the PCI domain
-     * */
-    if( chamFctTable.InitPci( NULL,
-							  z25HdlP->pathInfo[i].pci.bus,
-							  z25HdlP->pathInfo[i].pci.dev,
-							  z25HdlP->pathInfo[i].pci.fct,
-							  &chamHdl) != CHAMELEON_OK ){
-        DBGWRT_ERR( (z25HdlP->dbgHdlP,
-            "*** Z25/Z125 - Chameleon V2 PCI initialization failed.\n") );
-        return Z25_ERROR;
+    if( LocParseChamTable(z25HdlP, pathIndex) != Z25_OK ){
+        IZ25_PROF_RETURN(IZ25_PROF_FIND_UNITS, Z25_ERROR);
     }
 
-    while( G_modId[k] != IZ25_MODID_END ){
-        /* find 16Z025/16Z125 and 16Z057 units in Chameleon table */
-        chamFind.devId    =  CHAM_ModCodeToDevId( G_modId[k] );
-        chamFind.variant  = -1; chamFind.instance = -1;
-	    chamFind.busId    = -1; chamFind.group    = -1;
-	    chamFind.bootAddr = -1;
+    /* units of this path follow the units found so far */
+    pathP->start16Z25Unit = z25HdlP->no16Z25Dev;
 
-        while( chamFctTable.InstanceFind(chamHdl,
-                                         unit,
-                                         chamFind,
-										&chamInfo,
-										NULL,
-										NULL) == CHAMELEONV2_UNIT_FOUND)
-        {
+    /* 16Z025/16Z125 and 16Z057 units in order of G_modId */
+    for( k=0; k<IZ25_NO_MODID; k++ ){
+        for( idx=0;
+             (chamUnitP = LocChamUnitGet(pathP, k, idx)) != NULL;
+             idx++ ){
             DBGWRT_2( (z25HdlP->dbgHdlP,
                     "Z25/Z125 - uart id 0x%lx found in chameleon table (unit=%d)\n",
                     G_modId[k], unit) );
 
-            if((*maxUnitsP >= Z25_MAX_UNITS) || (z25HdlP->no16Z25Dev >= Z25_MAX_UNITS) ){
-                /* maximum number of supported UART units reached */
-                /* should appear as error, but return Z25_OK because
-                   devices were correctly recognized and initialized */
-                z25HdlP->no16Z25Dev = Z25_MAX_UNITS;
-                DBGWRT_ERR( (z25HdlP->dbgHdlP,
-                "*** Z25/Z125 - Maximum number of supported devices reached !\n") );
-
-                DBGWRT_2( (z25HdlP->dbgHdlP,
-                    "Z25/Z125 - %d 16Z25/16Z125 uart(s) found => %d single channels.\n",
-                    z25HdlP->no16Z25Dev, z25HdlP->noUarts) );
-                return Z25_OK;
-            }
-
             if( z25HdlP->usePciIrq == Z25_PCI_IRQ_ENABLED ){
                  DBGWRT_2( (z25HdlP->dbgHdlP,
                     "Z25/Z125 - uart unit %d uses PCI interrupt.\n",
                     unit) );
 
+                 G_Z25_PciCfgReads++;
                  OSS_PciGetConfig(NULL,
-							 z25HdlP->pathInfo[i].pci.bus,
-							 z25HdlP->pathInfo[i].pci.dev,
-							 z25HdlP->pathInfo[i].pci.fct,
+							 pathP->pci.bus,
+							 pathP->pci.dev,
+							 pathP->pci.fct,
 							 OSS_PCI_INTERRUPT_LINE, &irq);
             }
             else {
                 DBGWRT_2( (z25HdlP->dbgHdlP,
                     "Z25/Z125 - uart unit %d uses chameleon interrupt.\n",
                     unit) );
-                irq = chamInfo.interrupt + z25HdlP->irqOffset;
+                irq = chamUnitP->interrupt + z25HdlP->irqOffset;
             }
 
             /* initalize UART unit */
-            if( LocInitUartUnit(hdlP, (u_int32)chamInfo.addr, irq, G_modId[k]) != 0 ){
+            if( LocInitUartUnit(hdlP, chamUnitP->addr, irq, G_modId[k]) != 0 ){
                 DBGWRT_ERR((z25HdlP->dbgHdlP,
                     "*** Z25/Z125 - Error initializing uart unit %d.\n", unit));
-                return Z25_ERROR;
-            }
-
-            /* store start unit */
-            if( i == 0 ){/* first device */
-                z25HdlP->pathInfo[i].start16Z25Unit = 0;
-            }
-            else{/* second and follwing devices */
-					z25HdlP->pathInfo[i].start16Z25Unit =
-                    z25HdlP->pathInfo[i-1].no16Z25Units +
-                    z25HdlP->pathInfo[i-1].start16Z25Unit;
+                IZ25_PROF_RETURN(IZ25_PROF_FIND_UNITS, Z25_ERROR);
             }
 
             /* no of units in PCI path */
-            *unitP = z25HdlP->pathInfo[i].start16Z25Unit;
-            if( *maxUnitsP < Z25_MAX_UNITS ){
-                *maxUnitsP = ++z25HdlP->pathInfo[i].no16Z25Units;
-            }
+            *unitP = pathP->start16Z25Unit;
+            *maxUnitsP = ++pathP->no16Z25Units;
 
             unit++;
-        }/* while */
-        k++;
-    } /* end for */
+        }
+    }
 
     DBGWRT_2( (z25HdlP->dbgHdlP,
         "Z25/Z125 - %d 16Z25/16Z125 uart(s) found => %d single channels.\n",
         z25HdlP->no16Z25Dev, z25HdlP->noUarts) );
 
-    return Z25_OK;
+    IZ25_PROF_RETURN(IZ25_PROF_FIND_UNITS, Z25_OK);
 } /* Z25_FindUartUnits */
 
 /**********************************************************************/
@@ -2524,10 +6521,45 @@ STATUS Z25_SetIntFunctions(Z25_HDL *hdlP,
         z25DevP->irqFct.fIntEnableP = (FUNCPTR)intEnableAddr;
     }
 
-
+
+
+    return Z25_OK;
+}/* Z25_SetIntFunctions */
+
+/**********************************************************************/
+/** Routine to set the time base for time scheduled transmission
+ *
+ *  This routine sets the time base of MEN_UART_IOCTL_WRITE_AT, which
+ *  returns ENOSYS until it is set. The time base must be a free running
+ *  32 bit up counter over the full 32 bit range, e.g. a hardware timer.
+ *  sysTimestamp is no valid time base on most BSPs, it rolls over at
+ *  each system clock tick. The transmit time must be less than 2^31
+ *  counts ahead.
+ *
+ *  The optional alarm function has the prototype
+ *  STATUS alarm(UINT32 time, FUNCPTR fct, int arg) and must call
+ *  fct(arg) at interrupt level when the time base reaches 'time'.
+ *  Without it, the writing task delays itself and polls the last tick.
+ *
+ *  \param timeGetAddr      time base read function, UINT32 (*)(void)
+ *  \param timeAlarmAddr    alarm function or NULL
+ *  \param freq             time base frequency [Hz]
+ *
+ *  \return Z25_OK or Z25_ERROR
+ */
+STATUS Z25_SetTimeBase(FUNCPTR timeGetAddr,
+                       FUNCPTR timeAlarmAddr,
+                       u_int32 freq){
+    if( (timeGetAddr == NULL) || (freq == 0) ){
+        return Z25_ERROR;
+    }
+
+    G_Z25_TimeGetP   = timeGetAddr;
+    G_Z25_TimeAlarmP = timeAlarmAddr;
+    G_Z25_TimeFreq   = freq;
 
     return Z25_OK;
-}/* Z25_SetIntFunctions */
+}/* Z25_SetTimeBase */
 
 /**********************************************************************/
 /** Routine to set the UART clock frequency
@@ -2544,6 +6576,7 @@ STATUS Z25_SetIntFunctions(Z25_HDL *hdlP,
 STATUS Z25_SetBaseBaud(Z25_HDL *hdlP,
                         u_int32 frequency,
                         u_int16 unit){
+    IZ25_PROF_DECL
     Z25_DEV_TS *z25DevP;		/* Z25 resources */
     HDL_16Z25  *unitHdlP;		/* 16Zx25 handle */
     /* TS_16Z25_UNIT *tmphdlP;*/ 	/* 16Z025 resources */
@@ -2552,12 +6585,16 @@ STATUS Z25_SetBaseBaud(Z25_HDL *hdlP,
     u_int16 maxChannels = 0;
 
     if( hdlP == NULL ){
-        return 1;
+        IZ25_PROF_RETURN(IZ25_PROF_BASE_BAUD, 1);
     }
     else {
         z25DevP = hdlP;
     }
 
+    if( unit >= z25DevP->no16Z25Dev ){
+        IZ25_PROF_RETURN(IZ25_PROF_BASE_BAUD, 1);
+    }
+
     /* set UART clock frequency for all channels */
     if( z25DevP->quadUart[unit][0].uartCore == IZ25_MODID_2){
         maxChannels = IZ25_MIN_UARTS_PER_DEV;
@@ -2576,7 +6613,7 @@ STATUS Z25_SetBaseBaud(Z25_HDL *hdlP,
         }
     }
 
-    return Z25_OK;
+    IZ25_PROF_RETURN(IZ25_PROF_BASE_BAUD, Z25_OK);
 }/* Z25_SetBaseBaud */
 
 /**********************************************************************/
@@ -2584,18 +6621,38 @@ STATUS Z25_SetBaseBaud(Z25_HDL *hdlP,
  *
  *  This routine allocates memory for the device resources and calls the
  *  routine LocFindChameleonDevices to find the devices.
+ *  The handle is shared: later calls return the handle of the first call
+ *  and increment its reference count instead of scanning the PCI bus again.
+ *  Each call must be balanced by Z25_FreeHandle.
  *
  *  \return Z25_HDL - Z25 handle
  */
 Z25_HDL * Z25_InitDriver(void){
+    IZ25_PROF_DECL
     Z25_DEV_TS *z25DevP = NULL;      /* Z25 resources */
+    u_int16 noUnits = 0;             /* units counted in Chameleon tables */
+
+    if( LocSharedLock() != Z25_OK ){
+        IZ25_PROF_RETURN(IZ25_PROF_INIT_DRIVER, NULL);
+    }
+
+    /* reuse previous discovery */
+    if( G_Z25_SharedHdlP != NULL ){
+        G_Z25_SharedRefCnt++;
+        z25DevP = G_Z25_SharedHdlP;
+        DBGWRT_1(( z25DevP->dbgHdlP, "Z25_InitDriver: shared handle, refCnt=%d\n",
+                   G_Z25_SharedRefCnt ));
+        LocSharedUnlock();
+        IZ25_PROF_RETURN(IZ25_PROF_INIT_DRIVER, z25DevP);
+    }
 
     /*------------------------------+
      | initialization section       |
      +------------------------------*/
     /* create Z25 handle */
     if( LocInitHandle((Z25_HDL *)&z25DevP) != Z25_OK ){
-        return NULL;
+        LocSharedUnlock();
+        IZ25_PROF_RETURN(IZ25_PROF_INIT_DRIVER, NULL);
     }
 
     /*----------------------------+
@@ -2604,18 +6661,140 @@ Z25_HDL * Z25_InitDriver(void){
 
     DBGWRT_1(( z25DevP->dbgHdlP, "Z25_InitDriver:\n" ));
 
-    if( LocFindChameleonDevices(z25DevP, (G_Z25_ChamPciDomain & 0xff) ) != Z25_OK ){
+    if( LocFindChameleonDevices(z25DevP, LocDomainMask()) != Z25_OK ){
         DBGWRT_ERR( (z25DevP->dbgHdlP,
             "*** Z25/Z125 - No Chameleon devices found.\n") );
         Z25_FreeHandle((Z25_HDL *)&z25DevP);
-        return NULL;
+        LocSharedUnlock();
+        IZ25_PROF_RETURN(IZ25_PROF_INIT_DRIVER, NULL);
+    }
+
+    /* size unit tables by the units present, LocInitUartUnit grows
+       them if the count was short. The tables can not grow once a
+       channel is created, so keep spare entries for Z25_RescanPci */
+    noUnits = LocCountUartUnits(z25DevP);
+    if( LocAllocUnitTables(z25DevP,
+            noUnits + IZ25_UNIT_TABLE_SPARE) != Z25_OK ){
+        Z25_FreeHandle((Z25_HDL *)&z25DevP);
+        LocSharedUnlock();
+        IZ25_PROF_RETURN(IZ25_PROF_INIT_DRIVER, NULL);
     }
 
+    G_Z25_SharedHdlP = z25DevP;
+    G_Z25_SharedRefCnt = 1;
+    LocSharedUnlock();
+
     DBGWRT_1((z25DevP->dbgHdlP, "Z25/Z125 - Z25_InitDriver was successfull !\n"));
 
-    return z25DevP;
+    IZ25_PROF_RETURN(IZ25_PROF_INIT_DRIVER, z25DevP);
 }/* Z25_InitDriver */
 
+/**********************************************************************/
+/** Routine to initialize the driver resources from a static device map
+ *
+ *  This routine is the counterpart of Z25_InitDriver for systems with a
+ *  fixed hardware configuration. The Chameleon FPGAs are taken from the
+ *  given map, the PCI bus is not scanned. The UART units of an entry are
+ *  taken from the map too if given, otherwise from the Chameleon table of
+ *  the FPGA. Paths of the map have no PCI bridge path, use the unit
+ *  numbers returned by Z25_FindUartUnits to install them.
+ *
+ *  The map is referenced by the handle, it must stay valid. The handle
+ *  is shared like the one of Z25_InitDriver, if a handle already exists
+ *  the map is ignored. Z25_VerifyStaticMap checks the map against the
+ *  hardware.
+ *
+ *  \param mapP         static device map
+ *  \param noDevs       number of entries in mapP
+ *
+ *  \return Z25_HDL - Z25 handle or NULL in case of error
+ */
+Z25_HDL * Z25_InitDriverStatic(const Z25_STATIC_DEV *mapP,
+                               u_int16 noDevs){
+    IZ25_PROF_DECL
+    Z25_DEV_TS *z25DevP = NULL;      /* Z25 resources */
+    const Z25_STATIC_DEV *sdP;       /* static map entry */
+    Z25_PATH_TS *pathP;              /* PCI path of entry */
+    u_int16 noUnits = 0;             /* units of all paths */
+    u_int16 pathIndex = 0;
+    u_int16 i;
+
+    if( (mapP == NULL) || (noDevs == 0) ){
+        IZ25_PROF_RETURN(IZ25_PROF_INIT_DRIVER, NULL);
+    }
+
+    if( LocSharedLock() != Z25_OK ){
+        IZ25_PROF_RETURN(IZ25_PROF_INIT_DRIVER, NULL);
+    }
+
+    /* reuse previous discovery */
+    if( G_Z25_SharedHdlP != NULL ){
+        G_Z25_SharedRefCnt++;
+        z25DevP = G_Z25_SharedHdlP;
+        DBGWRT_1(( z25DevP->dbgHdlP,
+                   "Z25_InitDriverStatic: shared handle, refCnt=%d\n",
+                   G_Z25_SharedRefCnt ));
+        LocSharedUnlock();
+        IZ25_PROF_RETURN(IZ25_PROF_INIT_DRIVER, z25DevP);
+    }
+
+    if( LocInitHandle((Z25_HDL *)&z25DevP) != Z25_OK ){
+        LocSharedUnlock();
+        IZ25_PROF_RETURN(IZ25_PROF_INIT_DRIVER, NULL);
+    }
+
+    DBGWRT_1(( z25DevP->dbgHdlP, "Z25_InitDriverStatic: %d device(s)\n",
+               noDevs ));
+
+    for( i=0; i<noDevs; i++ ){
+        sdP = &mapP[i];
+
+        if( LocAddPath(z25DevP, OSS_MERGE_BUS_DOMAIN(sdP->bus, sdP->domain),
+                       sdP->dev, sdP->fct, &pathIndex) != Z25_OK ){
+            goto CLEANUP;
+        }
+        pathP = &z25DevP->pathInfo[pathIndex];
+
+#ifdef Z25_USE_VXBPCI_FUNCS
+        pathP->pci.vxbDevID = sysGetPciCtrlID(sdP->domain);
+#else
+        pathP->pci.vxbDevID = G_Z25_vxbDevID;
+#endif
+
+        /* units given, the Chameleon table is not read */
+        if( (sdP->unitP != NULL) && !pathP->chamIdx.parsed ){
+            if( LocStaticChamTable(z25DevP, pathIndex, sdP) != Z25_OK ){
+                goto CLEANUP;
+            }
+        }
+    }
+
+    z25DevP->staticMapP   = mapP;
+    z25DevP->noStaticDevs = noDevs;
+
+    noUnits = LocCountUartUnits(z25DevP);
+    if( LocAllocUnitTables(z25DevP,
+            (noUnits > 0) ? noUnits : IZ25_UNIT_TABLE_STEP) != Z25_OK ){
+        goto CLEANUP;
+    }
+
+    G_Z25_SharedHdlP = z25DevP;
+    G_Z25_SharedRefCnt = 1;
+    LocSharedUnlock();
+
+    DBGWRT_1((z25DevP->dbgHdlP,
+        "Z25/Z125 - Z25_InitDriverStatic was successfull !\n"));
+
+    IZ25_PROF_RETURN(IZ25_PROF_INIT_DRIVER, z25DevP);
+
+CLEANUP:
+    DBGWRT_ERR((z25DevP->dbgHdlP,
+        "*** Z25/Z125 - Invalid static device map entry %d.\n", i));
+    Z25_FreeHandle((Z25_HDL *)&z25DevP);
+    LocSharedUnlock();
+    IZ25_PROF_RETURN(IZ25_PROF_INIT_DRIVER, NULL);
+}/* Z25_InitDriverStatic */
+
 /**********************************************************************/
 /** Routine to parse a directly specified PCI location for a
  *  Z(1)25 UART containing device
@@ -2675,7 +6854,7 @@ Z25_HDL * Z25_CreateDevice(int8 	*devNameP,
 {
     Z25_DEV_TS *z25DevP=NULL;      	/* Z25 resources */
     int8 tmpDevicePath[IZ25_PATH_LENGTH];     /* hexadecimal device path */
-    u_int8 i, j, l_const  = 255;              /* loop index */
+    u_int16 i, j, l_const = 0xffff;           /* loop index */
     u_int8 k = 0;               /* index */
     int32 pdom, pb, pd, pf;    /* PCI domain, bus, dev, function */
     u_int16 unit 	  = 0;    /* UART unit */
@@ -2716,9 +6895,13 @@ Z25_HDL * Z25_CreateDevice(int8 	*devNameP,
         frequency = uartFreq;
     }
 
+    /* handle may be shared with previous calls, set explicitly */
     if( usePciIrq > 0 ){
         z25DevP->usePciIrq = Z25_PCI_IRQ_ENABLED;
     }
+    else {
+        z25DevP->usePciIrq = Z25_PCI_IRQ_DISABLED;
+    }
 
     /* set interrupt functions */
     Z25_SetIntFunctions(z25DevP, irqBase, intConnectAddr, intEnableAddr);
@@ -2735,11 +6918,15 @@ Z25_HDL * Z25_CreateDevice(int8 	*devNameP,
     				"Z25_CreateDevice: direct PCI location specified, searching UART units..\n" ));
 
     	/* direct PCI device specified, omit PCI path scanning. Interpret the number behind "PCI */
-    	pathIndex = 0;
     	DRV_ParseDirectPciLoc((char*)pathStringP, &pdom,&pb,&pd,&pf);
-    	z25DevP->pathInfo[pathIndex].pci.bus 	= OSS_MERGE_BUS_DOMAIN(pb, pdom);
-    	z25DevP->pathInfo[pathIndex].pci.dev 	= (u_int16)pd;
-    	z25DevP->pathInfo[pathIndex].pci.fct 	= (u_int16)pf;
+
+    	/* the handle is shared, do not overwrite a found path */
+    	if( LocAddPath(z25DevP, OSS_MERGE_BUS_DOMAIN(pb, pdom),
+    			(u_int16)pd, (u_int16)pf, &pathIndex) != Z25_OK ){
+    		DBGWRT_ERR((z25DevP->dbgHdlP,
+    				"*** Z25/Z125 - Error adding PCI location.\n"));
+    		goto CLEANUP;
+    	}
 
     	if( Z25_FindUartUnits(z25DevP, pathIndex, &unit, &maxUnit) != Z25_OK ){
     		DBGWRT_ERR((z25DevP->dbgHdlP,
@@ -2770,6 +6957,11 @@ Z25_HDL * Z25_CreateDevice(int8 	*devNameP,
     	}
     }
 
+    if( z25DevP->pathInfo[pathIndex].installed ){
+        DBGWRT_ERR((z25DevP->dbgHdlP,
+            "*** Z25/Z125 - PCI path already installed !\n"));
+        goto CLEANUP;
+    }
     z25DevP->pathInfo[pathIndex].installed = TRUE;
 
     for(j=unit; j<(unit+maxUnit); j++){
@@ -2778,7 +6970,7 @@ Z25_HDL * Z25_CreateDevice(int8 	*devNameP,
         +------------------------------*/
 
 	/* KlocWork: check validity of index j first */
-    	if ( j >= IZ25_MAX_UNITS ) {
+    	if ( j >= z25DevP->no16Z25Dev ) {
                     DBGWRT_ERR((z25DevP->dbgHdlP, "*** Z25/Z125 - internal bug: too many /tty instances found ?\n"));
                     goto CLEANUP;
     	}
@@ -2789,7 +6981,7 @@ Z25_HDL * Z25_CreateDevice(int8 	*devNameP,
             }
             loopIndex = IZ25_MIN_UARTS_PER_DEV;
             ++k;
-            if( l_const == 255 ){
+            if( l_const == 0xffff ){
                 l_const = j;
             }
         }
@@ -2819,137 +7011,597 @@ Z25_HDL * Z25_CreateDevice(int8 	*devNameP,
                                         devNameP,
                                         j,
                                         i,
-                                        Z25_RX_BUFF_SIZE,
-                                        Z25_TX_BUFF_SIZE) != Z25_OK ){
+                                        Z25_BUFF_SIZE_AUTO,
+                                        Z25_BUFF_SIZE_AUTO) != Z25_OK ){
                 DBGWRT_ERR((z25DevP->dbgHdlP,
                     "*** Z25/Z125 - Z25_InstallTtyInterface\n"));
                 goto CLEANUP;
             }
         }
     }
-    DBGWRT_2((z25DevP->dbgHdlP,
-        "Z25/Z125 - Driver initialization finished.\n"));
+    DBGWRT_2((z25DevP->dbgHdlP,
+        "Z25/Z125 - Driver initialization finished.\n"));
+
+    DBGWRT_1((z25DevP->dbgHdlP,
+        "Z25/Z125 - UART base frequency set to %ld Hz\n", frequency));
+
+    return (Z25_HDL *)z25DevP;
+
+CLEANUP:
+    DBGWRT_ERR((z25DevP->dbgHdlP,
+        "*** Z25/Z125 - Driver initialization aborted.\n"));
+
+    Z25_FreeHandle((Z25_HDL *)&z25DevP);
+    return NULL;
+}/* Z25_CreateDevice */
+
+/**********************************************************************/
+/** Routine to initialize the driver at boot time
+ *
+ *  This routine is used to make the BSP initialization of the driver.
+ *  It must be called in sysSerialHwInit2. Before using this function call
+ *  Z25_InitDriver and Z25_FindUartUnits to obtain a valid Z25 handle
+ *  and the available UART units.
+ *
+ *  \param hdlP             Z25 handle returned by Z25_Init
+ *  \param unit             number of 16Zx25 unit
+ *  \param channel          number of channel in unit
+ *
+ *  \return Z25_OK or Z25_ERROR
+ */
+STATUS Z25_InitDriverAtBoot(Z25_HDL *hdlP,
+                             u_int16 unit,
+                             u_int16 channel)
+{
+	STATUS error = Z25_OK;
+    Z25_DEV_TS *z25DevP;  /* Z25 resources */
+
+    if( (z25DevP = hdlP) == NULL ||
+    	unit >= z25DevP->no16Z25Dev ||
+    	channel >= Z25_MAX_UARTS_PER_DEV ||
+    	z25DevP->quadUart[unit][channel].addr == 0 ){
+        return Z25_ERROR;
+    }
+
+    DBGWRT_1((z25DevP->dbgHdlP,
+        "Z25/Z125 - Z25_InitDriverAtBoot\n"));
+
+    z25DevP->quadUart[unit][channel].u.sioT.pDrvFuncs  =
+        (SIO_DRV_FUNCS  *)&G_sioDrvFuncs;
+    z25DevP->quadUart[unit][channel].u.sioT.mode  = SIO_MODE_INT;
+
+    error = LocInitChannels(z25DevP, unit, channel, LZ25_CREATE_TYPE_AT_BOOT);
+
+    if( error == Z25_OK ){
+        LocEnableInterrupt(z25DevP, unit, channel);
+    }
+	return error;
+} /* Z25_InitDriverAtBoot */
+
+/**********************************************************************/
+/** Routine to install the UARTs in the VxWorks TTY environment
+ *
+ *  This routine install the UARTs in the VxWorks TTY environment.
+ *
+ *  \param hdlP         Z25 handle returned by Z25_Init
+ *  \param devNameP     device name
+ *  \param unit         unit to install
+ *  \param noOfChan     number of channels to install
+ *  \param rxBuffSize   Rx buffer size (Z25_BUFF_SIZE_AUTO=derived from baudrate)
+ *  \param txBuffSize   Tx buffer size (Z25_BUFF_SIZE_AUTO=derived from baudrate)
+ *
+ *  \return Z25_OK or Z25_ERROR
+ */
+STATUS Z25_InstallTtyInterface(Z25_HDL * hdlP,
+                                int8 *devNameP,
+                                u_int16 unit,
+                                u_int16 noOfChan,
+                                u_int32 rxBuffSize,
+                                u_int32 txBuffSize){
+    IZ25_PROF_DECL
+    Z25_DEV_TS *z25DevP;  /* Z25 resources */
+    Z25_TY_CO_DEV_TS *chanP;    /* channel */
+    int8 tyName[IZ25_MAX_DEV_NAME];        /* TTY device name */
+    u_int32 baudrate;           /* baudrate for auto sized buffers */
+
+    if( hdlP == NULL ){
+        IZ25_PROF_RETURN(IZ25_PROF_INSTALL_TTY, Z25_ERROR);
+    }
+    else{
+        z25DevP = hdlP;
+    }
+
+    bzero((void*)tyName, sizeof(tyName));
+
+    if( unit >= z25DevP->no16Z25Dev || noOfChan >= Z25_MAX_UARTS_PER_DEV ){
+        IZ25_PROF_RETURN(IZ25_PROF_INSTALL_TTY, Z25_ERROR);
+    }
+
+    chanP = &z25DevP->quadUart[unit][noOfChan];
+
+    if( chanP->addr != 0 ){/* init ty interface */
+        /* the channel is set to the default baudrate below */
+        baudrate = (chanP->uartUnit.baudrate != 0) ?
+                    chanP->uartUnit.baudrate : Z25_DEFAULT_BAUDRATE;
+
+        chanP->rxBuffAuto = (rxBuffSize == Z25_BUFF_SIZE_AUTO);
+        if( chanP->rxBuffAuto ){
+            rxBuffSize = LocBuffSizeAuto(baudrate, Z25_RX_BUFF_SIZE);
+        }
+        chanP->txBuffAuto = (txBuffSize == Z25_BUFF_SIZE_AUTO);
+        if( chanP->txBuffAuto ){
+            txBuffSize = LocBuffSizeAuto(baudrate, Z25_TX_BUFF_SIZE);
+        }
+        chanP->rxBuffSize = rxBuffSize;
+        chanP->txBuffSize = txBuffSize;
+
+        if( tyDevInit( &chanP->u.tyDev,
+                        (int)rxBuffSize,
+                        (int)txBuffSize,
+                       (TY_LOC_CAST)LocStartup ) != OK ){
+            DBGWRT_ERR((z25DevP->dbgHdlP,
+                "*** Z25/Z125 - Error tyDevInit\n"));
+            IZ25_PROF_RETURN(IZ25_PROF_INSTALL_TTY, Z25_ERROR);
+        }
+
+        /* defaults only, the hardware is set up at the first open */
+        LocInitChannels(z25DevP, unit, noOfChan, LZ25_CREATE_TYPE_LATE);
+
+        /* add channel list to io system */
+        if( z25DevP->quadUart[unit][noOfChan].uartCore == IZ25_MODID_2 ){
+            /*  each z125 unit does only consist of one uart channel */
+            sprintf ((char*)tyName, "%s%s%d", devNameP, "/", unit);
+        }
+        else {
+            sprintf ((char*)tyName, "%s%d%s%d", devNameP, unit, "/", noOfChan);
+        }
+
+		/* store channel nr so we can unit value  */
+		z25DevP->quadUart[unit][noOfChan].unit = noOfChan;
+
+        if( iosDevAdd(&z25DevP->quadUart[unit][noOfChan].u.tyDev.devHdr,
+                      (char*)tyName, z25DevP->driverNumber[unit]) ){
+            DBGWRT_ERR((z25DevP->dbgHdlP,
+                "*** Z25/Z125 - Error iosDevAdd\n"));
+            IZ25_PROF_RETURN(IZ25_PROF_INSTALL_TTY, Z25_ERROR);
+        }
+    }
+
+    IZ25_PROF_RETURN(IZ25_PROF_INSTALL_TTY, Z25_OK);
+}/* Z25_InstallTtyInterface */
+
+/**********************************************************************/
+/** Routine to resize the software buffers of a channel
+ *
+ *  This routine replaces the tyLib Rx and Tx buffers of an installed
+ *  channel. The channel must be idle, i.e. not opened more than once,
+ *  both buffers empty and no transmission in progress.
+ *
+ *  \param hdlP         Z25 handle returned by Z25_Init
+ *  \param unit         unit of the channel
+ *  \param channel      channel number in unit
+ *  \param rxBuffSize   Rx buffer size (Z25_BUFF_SIZE_AUTO=derived from baudrate)
+ *  \param txBuffSize   Tx buffer size (Z25_BUFF_SIZE_AUTO=derived from baudrate)
+ *
+ *  \return Z25_OK or Z25_ERROR (errno EBUSY if the channel is not idle)
+ */
+STATUS Z25_SetBuffSize(Z25_HDL *hdlP,
+                        u_int16 unit,
+                        u_int16 channel,
+                        u_int32 rxBuffSize,
+                        u_int32 txBuffSize){
+    Z25_DEV_TS *z25DevP;  /* Z25 resources */
+    Z25_TY_CO_DEV_TS *chanP;    /* channel */
+
+    if( (z25DevP = hdlP) == NULL ||
+        unit >= z25DevP->no16Z25Dev ||
+        channel >= Z25_MAX_UARTS_PER_DEV ){
+        return Z25_ERROR;
+    }
+
+    chanP = &z25DevP->quadUart[unit][channel];
+
+    if( LocResizeBuffer(chanP, FALSE, rxBuffSize) != OK ){
+        return Z25_ERROR;
+    }
+
+    if( LocResizeBuffer(chanP, TRUE, txBuffSize) != OK ){
+        return Z25_ERROR;
+    }
+
+    return Z25_OK;
+}/* Z25_SetBuffSize */
+
+/**********************************************************************/
+/** Routine to apply a control request to an installed channel
+ *
+ *  This routine gives the installation code (e.g. Z25_MdisDriver) the
+ *  control requests of LocIoctl without opening the channel, e.g. to
+ *  set the poll mode or the flow control from the descriptor.
+ *
+ *  \param hdlP         Z25 handle returned by Z25_Init
+ *  \param unit         unit of the channel
+ *  \param channel      channel number in unit
+ *  \param request      control request (MEN_UART_IOCTL_x)
+ *  \param arg          control request argument
+ *
+ *  \return OK, ENOSYS or error of the request
+ */
+int Z25_ChannelIoctl(Z25_HDL *hdlP,
+                     u_int16 unit,
+                     u_int16 channel,
+                     int request,
+                     void *arg){
+    Z25_DEV_TS *z25DevP;  /* Z25 resources */
+    Z25_TY_CO_DEV_TS *chanP;    /* channel */
+
+    if( (z25DevP = hdlP) == NULL ||
+        unit >= z25DevP->no16Z25Dev ||
+        channel >= Z25_MAX_UARTS_PER_DEV ){
+        return Z25_ERROR;
+    }
+
+    chanP = &z25DevP->quadUart[unit][channel];
+    if( chanP->created == LZ25_CREATE_TYPE_NONE ){
+        return ENOSYS;
+    }
+
+    return LocIoctl(chanP, request, arg);
+}/* Z25_ChannelIoctl */
+
+/**********************************************************************/
+/** Routine to send one buffer on several channels
+ *
+ *  This routine copies the data once into a reference counted buffer and
+ *  queues it to the Tx descriptor queue (see MEN_UART_IOCTL_WRITEV) of
+ *  every selected channel. All transmitters are started in one pass with
+ *  interrupts locked, so an idle channel writes its first FIFO-full
+ *  directly. The start skew between the first and the last selected
+ *  channel is bounded by the FIFO fills of the channels before it,
+ *  i.e. (n-1) * Tx FIFO size register writes for n channels; the
+ *  interrupt latency grows by the same time. Channels with queued data
+ *  start after that data, channels in poll mode or with modem control
+ *  at their next poll or CTS. The routine blocks while a channel has no
+ *  free descriptor slot and returns before the data is sent, the
+ *  buffer may be reused then. The selected channels must be opened tty
+ *  channels, writers of a channel must be serialized by the caller.
+ *
+ *  \param hdlP         Z25 handle returned by Z25_Init
+ *  \param maskP        channel mask, bit unit*Z25_MAX_UARTS_PER_DEV+channel,
+ *                      see Z25_BCAST_MASK_SET
+ *  \param maskWords    number of u_int32 in maskP
+ *  \param bufP         data to send
+ *  \param len          number of bytes
+ *
+ *  \return Z25_OK or Z25_ERROR
+ */
+STATUS Z25_BroadcastWrite(Z25_HDL *hdlP,
+                          const u_int32 *maskP,
+                          u_int16 maskWords,
+                          const u_int8 *bufP,
+                          u_int32 len){
+    Z25_DEV_TS *z25DevP;        /* Z25 resources */
+    Z25_TY_CO_DEV_TS *chanP;    /* channel */
+    Z25_TX_DESC_Q_TS *qP;
+    Z25_BCAST_TS *bcastP;
+    MEN_UART_TX_DESC *descP;
+    u_int8 *dataP;
+    u_int32 bit, noBits, reserved;
+    u_int32 noChan = 0;
+    int lockKey;
+
+    if( (z25DevP = hdlP) == NULL || maskP == NULL || bufP == NULL ){
+        return Z25_ERROR;
+    }
+
+    noBits = (u_int32)maskWords * 32;
+
+    /* check the channels and create their queues */
+    for( bit=0; bit<noBits; bit++ ){
+        if( !(maskP[bit/32] & (1UL << (bit%32))) ){
+            continue;
+        }
+        if( (bit / Z25_MAX_UARTS_PER_DEV) >= z25DevP->no16Z25Dev ){
+            return Z25_ERROR;
+        }
+        chanP = &z25DevP->quadUart[bit / Z25_MAX_UARTS_PER_DEV]
+                                  [bit % Z25_MAX_UARTS_PER_DEV];
+        if( (chanP->created != LZ25_CREATE_TYPE_LATE) ||
+            (chanP->hwInit != TRUE) ||
+            (LocTxDescQGet(chanP) == NULL) ){
+            return Z25_ERROR;
+        }
+        noChan++;
+    }
+
+    if( (noChan == 0) || (len == 0) ){
+        return Z25_OK;
+    }
+
+    /* header, descriptors and the single copy of the data */
+    bcastP = (Z25_BCAST_TS *)malloc(sizeof(Z25_BCAST_TS) +
+                                    (noChan-1) * sizeof(MEN_UART_TX_DESC) +
+                                    len);
+    if( bcastP == NULL ){
+        return Z25_ERROR;
+    }
+    bcastP->refCnt = noChan;
+    dataP = (u_int8 *)&bcastP->desc[noChan];
+    memcpy(dataP, bufP, len);
+
+    /* reserve a slot of each channel, the start pass must not block */
+    for( bit=0, reserved=0; bit<noBits; bit++ ){
+        if( !(maskP[bit/32] & (1UL << (bit%32))) ){
+            continue;
+        }
+        qP = z25DevP->quadUart[bit / Z25_MAX_UARTS_PER_DEV]
+                              [bit % Z25_MAX_UARTS_PER_DEV].txDescQP;
+        if( semTake(qP->freeSem, WAIT_FOREVER) != OK ){
+            break;
+        }
+        reserved++;
+    }
+
+    if( reserved != noChan ){
+        for( bit=0; reserved>0; bit++ ){
+            if( maskP[bit/32] & (1UL << (bit%32)) ){
+                semGive(z25DevP->quadUart[bit / Z25_MAX_UARTS_PER_DEV]
+                                         [bit % Z25_MAX_UARTS_PER_DEV].txDescQP->freeSem);
+                reserved--;
+            }
+        }
+        free(bcastP);
+        return Z25_ERROR;
+    }
 
-    DBGWRT_1((z25DevP->dbgHdlP,
-        "Z25/Z125 - UART base frequency set to %ld Hz\n", frequency));
+    /* queue and start all channels in one pass */
+    descP = bcastP->desc;
+    lockKey = intLock();
+    for( bit=0; bit<noBits; bit++ ){
+        if( !(maskP[bit/32] & (1UL << (bit%32))) ){
+            continue;
+        }
+        chanP = &z25DevP->quadUart[bit / Z25_MAX_UARTS_PER_DEV]
+                                  [bit % Z25_MAX_UARTS_PER_DEV];
+        qP = chanP->txDescQP;
 
-    return (Z25_HDL *)z25DevP;
+        descP->bufP    = dataP;
+        descP->len     = len;
+        descP->doneSem = NULL;
+        descP->done    = 0;
 
-CLEANUP:
-    DBGWRT_ERR((z25DevP->dbgHdlP,
-        "*** Z25/Z125 - Driver initialization aborted.\n"));
+        qP->descP[qP->tail % IZ25_TX_DESC_MAX]  = descP;
+        qP->bcastP[qP->tail % IZ25_TX_DESC_MAX] = bcastP;
+        qP->tail++;
+        descP++;
 
-    Z25_FreeHandle((Z25_HDL *)&z25DevP);
-    return NULL;
-}/* Z25_CreateDevice */
+        LocStartup(chanP);
+    }
+    intUnlock(lockKey);
+
+    return Z25_OK;
+}/* Z25_BroadcastWrite */
 
 /**********************************************************************/
-/** Routine to initialize the driver at boot time
- *
- *  This routine is used to make the BSP initialization of the driver.
- *  It must be called in sysSerialHwInit2. Before using this function call
- *  Z25_InitDriver and Z25_FindUartUnits to obtain a valid Z25 handle
- *  and the available UART units.
+/** Routine to create a bonded device
+ *
+ *  This routine creates the i/o system device devNameP which stripes one
+ *  logical stream across the selected tty channels of a unit. write()
+ *  splits the data into sequence numbered chunks, chunk n is sent on
+ *  the n-th member modulo the number of members, so the throughput
+ *  scales with the number of channels. The receive interrupt of the
+ *  members reassembles the chunks in order, read() returns the
+ *  reassembled data. A chunk lost on a link is skipped once a later
+ *  chunk arrived on that link; the bond does not retransmit.\n
+ *  If the reader falls behind, the members deassert RTS until it made
+ *  space. To avoid data loss, the members on both sides must use
+ *  RTS/CTS flow control (MEN_UART_IOCTL_RTS_CTS on the bonded device,
+ *  Z125 only), chunks which still arrive with a full window are dropped
+ *  and counted as rxDropped.\n
+ *  Both sides must bond the same number of channels, wired in the same
+ *  order and set to the same line parameters (the line parameter
+ *  ioctl()s on the bonded device are passed to all members). The member
+ *  channels must not be open, they are opened at the first open of the
+ *  bonded device and are dedicated to it: a direct open() of a member
+ *  fails with errno EBUSY until Z25_BondDelete releases it.
  *
- *  \param hdlP             Z25 handle returned by Z25_Init
- *  \param unit             number of 16Zx25 unit
- *  \param channel          number of channel in unit
+ *  \param hdlP         Z25 handle returned by Z25_Init
+ *  \param devNameP     name of the bonded device, e.g. "/bondZ25_0"
+ *  \param unit         unit of the channels
+ *  \param chanMask     channels to bond, bit n = channel n
  *
  *  \return Z25_OK or Z25_ERROR
  */
-STATUS Z25_InitDriverAtBoot(Z25_HDL *hdlP,
-                             u_int16 unit,
-                             u_int16 channel)
-{
-	STATUS error = Z25_OK;
-    Z25_DEV_TS *z25DevP;  /* Z25 resources */
+STATUS Z25_BondCreate(Z25_HDL *hdlP,
+                      int8 *devNameP,
+                      u_int16 unit,
+                      u_int8 chanMask){
+    Z25_DEV_TS *z25DevP;        /* Z25 resources */
+    Z25_TY_CO_DEV_TS *chanP;    /* channel */
+    Z25_BOND_TS *bondP;
+    u_int32 rxSize = 0;
+    u_int16 i;
+    int lockKey;
 
     if( (z25DevP = hdlP) == NULL ||
-    	z25DevP->quadUart[unit][channel].addr == 0 ){
+        devNameP == NULL ||
+        unit >= z25DevP->no16Z25Dev ||
+        chanMask == 0 ||
+        (chanMask >> Z25_MAX_UARTS_PER_DEV) != 0 ){
         return Z25_ERROR;
     }
 
-    DBGWRT_1((z25DevP->dbgHdlP,
-        "Z25/Z125 - Z25_InitDriverAtBoot\n"));
+    if( (bondP = (Z25_BOND_TS *)malloc(sizeof(Z25_BOND_TS))) == NULL ){
+        return Z25_ERROR;
+    }
+    bzero((char *)bondP, sizeof(Z25_BOND_TS));
 
-    z25DevP->quadUart[unit][channel].u.sioT.pDrvFuncs  =
-        (SIO_DRV_FUNCS  *)&G_sioDrvFuncs;
+    for( i=0; i<Z25_MAX_UARTS_PER_DEV; i++ ){
+        if( !(chanMask & (1 << i)) ){
+            continue;
+        }
+        chanP = &z25DevP->quadUart[unit][i];
+        if( (chanP->created != LZ25_CREATE_TYPE_LATE) ||
+            (chanP->bondP != NULL) ||
+            (chanP->useCnt > 0) ){
+            DBGWRT_ERR((z25DevP->dbgHdlP,
+                "*** Z25/Z125 - channel %d/%d can not be bonded\n", unit, i));
+            free(bondP);
+            return Z25_ERROR;
+        }
+        bondP->member[bondP->noMembers++].chanP = chanP;
+        rxSize += chanP->rxBuffSize;
+    }
+    bondP->window = bondP->noMembers * IZ25_BOND_DEPTH;
+
+    bondP->rxRing = rngCreate((int)rxSize);
+    bondP->rxSem  = semBCreate(SEM_Q_FIFO, SEM_EMPTY);
+    bondP->rxWd   = wdCreate();
+    bondP->rdSem  = semMCreate(SEM_Q_PRIORITY |
+                               SEM_DELETE_SAFE |
+                               SEM_INVERSION_SAFE);
+    bondP->txSem  = semMCreate(SEM_Q_PRIORITY |
+                               SEM_DELETE_SAFE |
+                               SEM_INVERSION_SAFE);
+    if( (bondP->rxRing == NULL) ||
+        (bondP->rxSem == NULL) ||
+        (bondP->rxWd == NULL) ||
+        (bondP->rdSem == NULL) ||
+        (bondP->txSem == NULL) ){
+        LocBondFree(bondP);
+        return Z25_ERROR;
+    }
 
-    error = LocInitChannels(z25DevP, unit, channel, LZ25_CREATE_TYPE_AT_BOOT);
+    /* one i/o system driver for all bonded devices */
+    if( LocSharedLock() != OK ){
+        LocBondFree(bondP);
+        return Z25_ERROR;
+    }
+    if( G_Z25_BondDrvNum == 0 ){
+        G_Z25_BondDrvNum = iosDrvInstall( (FUNCPTR)NULL,
+                                          (FUNCPTR)NULL,
+                                          LocBondOpen,
+                                          LocBondClose,
+                                          LocBondRead,
+                                          LocBondWrite,
+                                          LocBondIoctl );
+        if( G_Z25_BondDrvNum == ERROR ){
+            G_Z25_BondDrvNum = 0;
+        }
+    }
+    LocSharedUnlock();
 
-    if( error == Z25_OK ){
-        LocEnableInterrupt(z25DevP, unit, channel);
+    if( G_Z25_BondDrvNum == 0 ){
+        DBGWRT_ERR((z25DevP->dbgHdlP,
+            "*** Z25/Z125 - Bond driver installation failed !\n"));
+        LocBondFree(bondP);
+        return Z25_ERROR;
     }
-	return error;
-} /* Z25_InitDriverAtBoot */
+
+    if( iosDevAdd(&bondP->devHdr, (char *)devNameP, G_Z25_BondDrvNum) ){
+        DBGWRT_ERR((z25DevP->dbgHdlP,
+            "*** Z25/Z125 - Error iosDevAdd\n"));
+        LocBondFree(bondP);
+        return Z25_ERROR;
+    }
+
+    /* hand the Rx data of the members to the bond */
+    lockKey = intLock();
+    for( i=0; i<bondP->noMembers; i++ ){
+        bondP->member[i].chanP->bondIdx = (u_int8)i;
+        bondP->member[i].chanP->bondP   = bondP;
+    }
+    intUnlock(lockKey);
+
+    DBGWRT_2((z25DevP->dbgHdlP, "Z25/Z125 - %s bonds %d channels\n",
+        devNameP, bondP->noMembers));
+
+    return Z25_OK;
+}/* Z25_BondCreate */
 
 /**********************************************************************/
-/** Routine to install the UARTs in the VxWorks TTY environment
+/** Routine to delete a bonded device
  *
- *  This routine install the UARTs in the VxWorks TTY environment.
+ *  This routine removes the bonded device devNameP created by
+ *  Z25_BondCreate from the i/o system and releases its member channels,
+ *  they can be opened directly again. The bonded device must be closed.
+ *  The interrupts of each member are disabled while it is released and
+ *  the Rx watchdog is stopped, so no ISR, LocPoll or LocBondRxWd uses
+ *  the bonded device when it is freed.
  *
- *  \param hdlP         Z25 handle returned by Z25_Init
- *  \param devNameP     device name
- *  \param unit         unit to install
- *  \param noOfChan     number of channels to install
- *  \param rxBuffSize   Rx buffer size
- *  \param txBuffSize   Tx buffer size
+ *  \param devNameP     name of the bonded device, e.g. "/bondZ25_0"
  *
  *  \return Z25_OK or Z25_ERROR
  */
-STATUS Z25_InstallTtyInterface(Z25_HDL * hdlP,
-                                int8 *devNameP,
-                                u_int16 unit,
-                                u_int16 noOfChan,
-                                u_int16 rxBuffSize,
-                                u_int16 txBuffSize){
-    Z25_DEV_TS *z25DevP;  /* Z25 resources */
-    int8 tyName[IZ25_MAX_DEV_NAME];        /* TTY device name */
+STATUS Z25_BondDelete(int8 *devNameP){
+    DEV_HDR *devHdrP;
+    Z25_BOND_TS *bondP;
+    Z25_TY_CO_DEV_TS *chanP;
+    char *tailP = NULL;
+    u_int8 ier[IZ25_MAX_UARTS_PER_DEV];  /* stored interrupt enables */
+    u_int16 i;
+    int lockKey;
 
-    if( hdlP == NULL ){
+    if( devNameP == NULL ){
         return Z25_ERROR;
     }
-    else{
-        z25DevP = hdlP;
-    }
 
-    bzero((void*)tyName, sizeof(tyName));
+    if( LocSharedLock() != OK ){
+        return Z25_ERROR;
+    }
 
-    if( z25DevP->quadUart[unit][noOfChan].addr != 0 ){/* init ty interface */
-        if( tyDevInit( &z25DevP->quadUart[unit][noOfChan].u.tyDev,
-                        rxBuffSize,
-                        txBuffSize,
-                       (TY_LOC_CAST)LocStartup ) != OK ){
-            DBGWRT_ERR((z25DevP->dbgHdlP,
-                "*** Z25/Z125 - Error tyDevInit\n"));
-            return Z25_ERROR;
-        }
+    devHdrP = iosDevFind((char *)devNameP, &tailP);
+    if( (devHdrP == NULL) ||
+        (tailP == NULL) || (*tailP != '\0') ||
+        (G_Z25_BondDrvNum == 0) ||
+        (devHdrP->drvNum != G_Z25_BondDrvNum) ){
+        LocSharedUnlock();
+        return Z25_ERROR;
+    }
+    bondP = (Z25_BOND_TS *)devHdrP;
 
-        LocInitChannels(z25DevP, unit, noOfChan, LZ25_CREATE_TYPE_LATE);
+    if( bondP->useCnt > 0 ){
+        LocSharedUnlock();
+        return Z25_ERROR;
+    }
 
-        /* add channel list to io system */
-        if( z25DevP->quadUart[unit][noOfChan].uartCore == IZ25_MODID_2 ){
-            /*  each z125 unit does only consist of one uart channel */
-            sprintf ((char*)tyName, "%s%s%d", devNameP, "/", unit);
-        }
-        else {
-            sprintf ((char*)tyName, "%s%d%s%d", devNameP, unit, "/", noOfChan);
-        }
+    /* keep the member ISRs away from the bond while releasing it */
+    for( i=0; i<bondP->noMembers; i++ ){
+        ier[i] = MZ25_DisableInterrupt(bondP->member[i].chanP->unitHdlP, 0);
+    }
 
-		/* store channel nr so we can unit value  */
-		z25DevP->quadUart[unit][noOfChan].unit = noOfChan;
+    lockKey = intLock();
+    for( i=0; i<bondP->noMembers; i++ ){
+        bondP->member[i].chanP->bondP = NULL;
+    }
+    intUnlock(lockKey);
+
+    wdCancel(bondP->rxWd);
+#ifdef _WRS_CONFIG_SMP
+    /* let an ISR, LocPoll or LocBondRxWd on another CPU finish */
+    taskDelay(1);
+    wdCancel(bondP->rxWd);
+#endif /* _WRS_CONFIG_SMP */
+
+    /* the members are no longer held for the bond reader */
+    if( bondP->rxHeld ){
+        lockKey = intLock();
+        LocBondRts(bondP, TRUE);
+        intUnlock(lockKey);
+    }
 
-        if( iosDevAdd(&z25DevP->quadUart[unit][noOfChan].u.tyDev.devHdr,
-                      (char*)tyName, z25DevP->driverNumber[unit]) ){
-            DBGWRT_ERR((z25DevP->dbgHdlP,
-                "*** Z25/Z125 - Error iosDevAdd\n"));
-            return Z25_ERROR;
-        }
+    for( i=0; i<bondP->noMembers; i++ ){
+        chanP = bondP->member[i].chanP;
+        MZ25_EnableInterrupt(chanP->unitHdlP, ier[i]);
     }
-    LocEnableInterrupt(z25DevP, unit, noOfChan);
+
+    iosDevDelete(&bondP->devHdr);
+    LocSharedUnlock();
+
+    LocBondFree(bondP);
 
     return Z25_OK;
-}/* Z25_InstallTtyInterface */
+}/* Z25_BondDelete */
 
 /**********************************************************************/
 /** Routine to get the UART unit information
@@ -3022,6 +7674,10 @@ STATUS Z25_GetIosDriverNumber(Z25_HDL * hdlP,
     else{
         z25DevP = hdlP;
     }
+
+    if( unit >= z25DevP->no16Z25Dev ){
+        return Z25_ERROR;
+    }
 #if 0   /* parameter reminder  */
 int iosDrvInstall
     (
@@ -3039,7 +7695,7 @@ int iosDrvInstall
                                                      (FUNCPTR)NULL,
                                                      LocOpen,
                                                      LocClose,
-                                                     tyRead,
+                                                     LocRead,
                                                      tyWrite,
                                                      LocIoctl );
         if( z25DevP->driverNumber[unit] == ERROR ){
@@ -3067,16 +7723,20 @@ int iosDrvInstall
 /** Routine to free driver handle
  *
  *  This routine frees the Z25 driver resources, which were allocated
- *  by LocInitHandle.
+ *  by LocInitHandle. The shared handle is released only when its last
+ *  reference is dropped, *hdlP is set to NULL then. A handle with
+ *  installed channels or connected interrupts can not be freed, the
+ *  reference is kept and *hdlP stays valid.
  *
  *  \param hdlP         Z25 handle returned by Z25_Init
  *
- *  \return Z25_OK or Z25_ERROR
+ *  \return Z25_OK or Z25_ERROR (handle in use)
  */
 STATUS Z25_FreeHandle(Z25_HDL **hdlP){
     Z25_DEV_TS *z25DevP;      /* Z25 resources */
     u_int16 i, j;
     u_int16 loopIndex = 0;
+    BOOL inUse = FALSE;       /* channels or ISRs still reference the handle */
 
     z25DevP = *hdlP;
 
@@ -3084,6 +7744,47 @@ STATUS Z25_FreeHandle(Z25_HDL **hdlP){
         return Z25_ERROR;
     }
 
+    if( LocSharedLock() != Z25_OK ){
+        return Z25_ERROR;
+    }
+
+    if( z25DevP == G_Z25_SharedHdlP ){
+        if( --G_Z25_SharedRefCnt > 0 ){
+            *hdlP = NULL;
+            LocSharedUnlock();
+            return Z25_OK;
+        }
+    }
+
+    /*
+     * installed channels (opened lazily) and connected ISRs reference
+     * the handle, it must stay valid for them
+     */
+    for(i=0; i<z25DevP->no16Z25Dev && !inUse; i++){
+        if( z25DevP->isrUnitP[i] != NULL &&
+            z25DevP->isrUnitP[i]->connected ){
+            inUse = TRUE;
+        }
+        for(j=0; j<Z25_MAX_UARTS_PER_DEV && !inUse; j++){
+            if( z25DevP->quadUart[i][j].created != LZ25_CREATE_TYPE_NONE ){
+                inUse = TRUE;
+            }
+        }
+    }
+    if( inUse ){
+        DBGWRT_ERR((z25DevP->dbgHdlP,
+            "*** Z25/Z125 - Z25_FreeHandle: handle in use, not freed\n"));
+        if( z25DevP == G_Z25_SharedHdlP ){
+            G_Z25_SharedRefCnt++;
+        }
+        LocSharedUnlock();
+        return Z25_ERROR;
+    }
+
+    if( z25DevP == G_Z25_SharedHdlP ){
+        G_Z25_SharedHdlP = NULL;
+    }
+
     DBGEXIT((&z25DevP->dbgHdlP));
 
     /* free low-level instance, if already initialized */
@@ -3096,10 +7797,38 @@ STATUS Z25_FreeHandle(Z25_HDL **hdlP){
         }
 
         for(j=0; j<loopIndex; j++ ){
+            LocPollStop(&z25DevP->quadUart[i][j]);
             if( z25DevP->quadUart[i][j].unitHdlP != NULL ){
-                MZ25_FreeHandle(&z25DevP->quadUart[i][j].unitHdlP);
+                MZ25_ExitUnit(z25DevP->quadUart[i][j].unitHdlP);
+                z25DevP->quadUart[i][j].unitHdlP = NULL;
             }
+            if( z25DevP->quadUart[i][j].chanSem != NULL ){
+                semDelete(z25DevP->quadUart[i][j].chanSem);
+                z25DevP->quadUart[i][j].chanSem = NULL;
+            }
+        }
+
+        if( z25DevP->isrUnitP[i] != NULL ){
+            semDelete(z25DevP->isrUnitP[i]->connectSem);
+            free(z25DevP->isrUnitP[i]);
+            z25DevP->isrUnitP[i] = NULL;
+        }
+    }
+
+    if( z25DevP->maxUnits > 0 ){
+        OSS_MemFree(NULL, (void *)z25DevP->quadUart,
+                    z25DevP->maxUnits * sizeof(*z25DevP->quadUart));
+        OSS_MemFree(NULL, (void *)z25DevP->isrUnitP,
+                    z25DevP->maxUnits * sizeof(*z25DevP->isrUnitP));
+        OSS_MemFree(NULL, (void *)z25DevP->driverNumber,
+                    z25DevP->maxUnits * sizeof(*z25DevP->driverNumber));
+    }
+    if( z25DevP->pathInfo != NULL ){
+        for(i=0; i<z25DevP->noPciPaths; i++){
+            LocFreeChamTable(&z25DevP->pathInfo[i]);
         }
+        OSS_MemFree(NULL, (void *)z25DevP->pathInfo,
+                    z25DevP->maxPciPaths * sizeof(Z25_PATH_TS));
     }
 
     OSS_MemFree(NULL, (void *)z25DevP, sizeof(Z25_DEV_TS));
@@ -3107,9 +7836,343 @@ STATUS Z25_FreeHandle(Z25_HDL **hdlP){
 
     *hdlP = z25DevP;
 
+    LocSharedUnlock();
+
     return Z25_OK;
 }/* Z25_FreeHandle */
 
+/**********************************************************************/
+/** Routine to rescan the PCI bus for Chameleon devices
+ *
+ *  This routine scans the PCI bus of the shared handle again and appends
+ *  Chameleon devices which were not found before to its PCI path table.
+ *  Known paths keep their index and state, so installed units are not
+ *  touched. Normally this is not needed, Z25_InitDriver scans once.
+ *
+ *  The unit tables can not be grown once a channel is created. If the
+ *  units of all paths exceed the spare entries (IZ25_UNIT_TABLE_SPARE),
+ *  the new paths are kept but Z25_ERROR is returned, their units can not
+ *  be installed then.
+ *
+ *  \return Z25_OK or Z25_ERROR
+ */
+STATUS Z25_RescanPci(void){
+    Z25_DEV_TS *z25DevP;         /* Z25 resources */
+    Z25_PATH_TS *oldPathP;       /* known PCI paths */
+    Z25_PATH_TS *newPathP;       /* PCI paths found by rescan */
+    Z25_PATH_TS *pathP = NULL;   /* merged PCI paths */
+    u_int16 oldMax, oldNo, newMax, newNo;
+    u_int16 i, j, noAdd = 0;
+    u_int16 noUnits;             /* units of all paths */
+    u_int32 gotSize = 0;
+    STATUS retVal = Z25_ERROR;
+
+    if( LocSharedLock() != Z25_OK ){
+        return Z25_ERROR;
+    }
+
+    z25DevP = G_Z25_SharedHdlP;
+    if( z25DevP == NULL ){
+        /* nothing discovered yet, next Z25_InitDriver scans */
+        LocSharedUnlock();
+        return Z25_ERROR;
+    }
+
+    oldPathP = z25DevP->pathInfo;
+    oldMax   = z25DevP->maxPciPaths;
+    oldNo    = z25DevP->noPciPaths;
+    z25DevP->pathInfo    = NULL;
+    z25DevP->maxPciPaths = 0;
+    z25DevP->noPciPaths  = 0;
+
+    if( LocFindChameleonDevices(z25DevP, LocDomainMask()) != Z25_OK ){
+        goto CLEANUP;
+    }
+    newPathP = z25DevP->pathInfo;
+    newMax   = z25DevP->maxPciPaths;
+    newNo    = z25DevP->noPciPaths;
+
+    /* count new paths */
+    for( i=0; i<newNo; i++ ){
+        for( j=0; j<oldNo; j++ ){
+            if( (newPathP[i].pci.bus == oldPathP[j].pci.bus) &&
+                (newPathP[i].pci.dev == oldPathP[j].pci.dev) &&
+                (newPathP[i].pci.fct == oldPathP[j].pci.fct) ){
+                break;
+            }
+        }
+        if( j == oldNo ){
+            newPathP[i].installed = TRUE;   /* mark as new */
+            noAdd++;
+        }
+    }
+
+    if( noAdd > 0 ){
+        pathP = (Z25_PATH_TS *)OSS_MemGet(NULL,
+                    (oldNo + noAdd) * sizeof(Z25_PATH_TS), &gotSize);
+        if( pathP == NULL ){
+            goto CLEANUP;
+        }
+        OSS_MemFill(NULL, gotSize, (char *)pathP, 0);
+
+        /* known paths first, indices stay valid */
+        if( oldNo > 0 ){
+            memcpy(pathP, oldPathP, oldNo * sizeof(Z25_PATH_TS));
+        }
+        for( i=0, j=oldNo; i<newNo; i++ ){
+            if( newPathP[i].installed ){
+                pathP[j] = newPathP[i];
+                pathP[j].installed = FALSE;
+                j++;
+            }
+        }
+
+        OSS_MemFree(NULL, (void *)newPathP, newMax * sizeof(Z25_PATH_TS));
+        if( oldPathP != NULL ){
+            OSS_MemFree(NULL, (void *)oldPathP, oldMax * sizeof(Z25_PATH_TS));
+        }
+        oldPathP = pathP;
+        oldMax   = oldNo + noAdd;
+        oldNo    = oldNo + noAdd;
+    }
+    else {
+        OSS_MemFree(NULL, (void *)newPathP, newMax * sizeof(Z25_PATH_TS));
+    }
+
+    DBGWRT_1((z25DevP->dbgHdlP, "Z25_RescanPci: %d new PCI path(s)\n", noAdd));
+    retVal = Z25_OK;
+
+CLEANUP:
+    /* a failed LocFindChameleonDevices may leave a table behind */
+    if( (retVal != Z25_OK) && (z25DevP->pathInfo != NULL) ){
+        OSS_MemFree(NULL, (void *)z25DevP->pathInfo,
+                    z25DevP->maxPciPaths * sizeof(Z25_PATH_TS));
+    }
+    z25DevP->pathInfo    = oldPathP;
+    z25DevP->maxPciPaths = oldMax;
+    z25DevP->noPciPaths  = oldNo;
+
+    /* the units of the new paths need free unit table entries */
+    if( (retVal == Z25_OK) && (noAdd > 0) ){
+        noUnits = LocCountUartUnits(z25DevP);
+        if( LocAllocUnitTables(z25DevP, noUnits) != Z25_OK ){
+            DBGWRT_ERR((z25DevP->dbgHdlP,
+                "*** Z25/Z125 - Z25_RescanPci: %d units, unit tables hold %d\n",
+                noUnits, z25DevP->maxUnits));
+            retVal = Z25_ERROR;
+        }
+    }
+
+    LocSharedUnlock();
+
+    return retVal;
+}/* Z25_RescanPci */
+
+/**********************************************************************/
+/** Routine to verify the static device map against the hardware
+ *
+ *  This routine scans the PCI bus like Z25_InitDriver and compares the
+ *  found Chameleon FPGAs and their UART units with the static device
+ *  map of the shared handle (see Z25_InitDriverStatic). Differences are
+ *  printed, the installed channels are not changed. The routine may take
+ *  as long as a full discovery, it is meant to be spawned as a low
+ *  priority task after boot.
+ *
+ *  \return Z25_OK if map and hardware match, otherwise Z25_ERROR
+ */
+STATUS Z25_VerifyStaticMap(void){
+    Z25_DEV_TS *z25DevP;            /* Z25 resources */
+    Z25_DEV_TS *scanP = NULL;       /* handle of the verify scan */
+    const Z25_STATIC_DEV *sdP;      /* static map entry */
+    Z25_CHAM_UNIT_TS *mapUnitP;     /* unit of the map */
+    Z25_CHAM_UNIT_TS *hwUnitP;      /* unit of the hardware */
+    u_int32 domainMask;             /* domains to scan */
+    u_int32 bus;                    /* merged PCI bus */
+    u_int16 pathIndex, scanIndex;
+    u_int16 i, k, idx;
+    u_int16 noErr = 0;
+
+    if( LocSharedLock() != Z25_OK ){
+        return Z25_ERROR;
+    }
+
+    z25DevP = G_Z25_SharedHdlP;
+    if( (z25DevP == NULL) || (z25DevP->staticMapP == NULL) ){
+        LocSharedUnlock();
+        return Z25_ERROR;
+    }
+
+    domainMask = LocDomainMask();
+    for( i=0; i<z25DevP->noStaticDevs; i++ ){
+        domainMask |= (u_int32)1 <<
+            (z25DevP->staticMapP[i].domain % LZ25_MAX_DOMAINS);
+    }
+    LocSharedUnlock();
+
+    /* scan into an own handle, the shared one is not locked meanwhile */
+    if( LocInitHandle((Z25_HDL *)&scanP) != Z25_OK ){
+        return Z25_ERROR;
+    }
+    if( LocFindChameleonDevices(scanP, domainMask) != Z25_OK ){
+        scanP->noPciPaths = 0;
+    }
+
+    if( LocSharedLock() != Z25_OK ){
+        Z25_FreeHandle((Z25_HDL *)&scanP);
+        return Z25_ERROR;
+    }
+
+    /* FPGAs missing in the map */
+    for( i=0; i<scanP->noPciPaths; i++ ){
+        if( LocFindPath(z25DevP, scanP->pathInfo[i].pci.bus,
+                        scanP->pathInfo[i].pci.dev,
+                        scanP->pathInfo[i].pci.fct,
+                        &pathIndex) != Z25_OK ){
+            printf("*** Z25/Z125 - static map: Chameleon device at "
+                   "PCI%d:%d.%d.%d not in map\n",
+                   OSS_DOMAIN_NBR(scanP->pathInfo[i].pci.bus),
+                   OSS_BUS_NBR(scanP->pathInfo[i].pci.bus),
+                   scanP->pathInfo[i].pci.dev,
+                   scanP->pathInfo[i].pci.fct);
+            noErr++;
+        }
+    }
+
+    /* map entries and their units */
+    for( i=0; i<z25DevP->noStaticDevs; i++ ){
+        sdP = &z25DevP->staticMapP[i];
+        bus = OSS_MERGE_BUS_DOMAIN(sdP->bus, sdP->domain);
+
+        if( (LocFindPath(scanP, bus, sdP->dev, sdP->fct,
+                         &scanIndex) != Z25_OK) ||
+            (LocParseChamTable(scanP, scanIndex) != Z25_OK) ){
+            printf("*** Z25/Z125 - static map: no Chameleon device at "
+                   "PCI%d:%d.%d.%d\n",
+                   sdP->domain, sdP->bus, sdP->dev, sdP->fct);
+            noErr++;
+            continue;
+        }
+        if( LocFindPath(z25DevP, bus, sdP->dev, sdP->fct,
+                        &pathIndex) != Z25_OK ){
+            continue;
+        }
+
+        for( k=0; k<IZ25_NO_MODID; k++ ){
+            for( idx=0; ; idx++ ){
+                mapUnitP = LocChamUnitGet(&z25DevP->pathInfo[pathIndex],
+                                          k, idx);
+                hwUnitP  = LocChamUnitGet(&scanP->pathInfo[scanIndex],
+                                          k, idx);
+                if( (mapUnitP == NULL) && (hwUnitP == NULL) ){
+                    break;
+                }
+                if( (mapUnitP == NULL) || (hwUnitP == NULL) ||
+                    (mapUnitP->addr != hwUnitP->addr) ||
+                    (mapUnitP->interrupt != hwUnitP->interrupt) ){
+                    printf("*** Z25/Z125 - static map: PCI%d:%d.%d.%d "
+                           "unit 0x%x/%d differs (map 0x%x irq %d, "
+                           "hw 0x%x irq %d)\n",
+                           sdP->domain, sdP->bus, sdP->dev, sdP->fct,
+                           G_modId[k], idx,
+                           mapUnitP ? mapUnitP->addr : 0,
+                           mapUnitP ? mapUnitP->interrupt : 0,
+                           hwUnitP ? hwUnitP->addr : 0,
+                           hwUnitP ? hwUnitP->interrupt : 0);
+                    noErr++;
+                }
+                if( (mapUnitP == NULL) || (hwUnitP == NULL) ){
+                    break;
+                }
+            }
+        }
+    }
+
+    DBGWRT_1((z25DevP->dbgHdlP,
+        "Z25_VerifyStaticMap: %d difference(s)\n", noErr));
+
+    LocSharedUnlock();
+    Z25_FreeHandle((Z25_HDL *)&scanP);
+
+    return (noErr == 0) ? Z25_OK : Z25_ERROR;
+}/* Z25_VerifyStaticMap */
+
+#ifdef Z25_PROFILE
+/**********************************************************************/
+/** Routine to mark the entry of a profiled phase
+ *
+ *  The timestamp timer is expected to restart with every system clock
+ *  tick, as the VxWorks timestamp drivers do, so the tick count is
+ *  taken along to measure phases longer than one tick.
+ *
+ *  \return counters at entry
+ */
+LOCAL Z25_PROF_MARK_TS LocProfStart(void){
+    Z25_PROF_MARK_TS mark;
+
+    mark.tick     = (u_int32)tickGet();
+    mark.stamp    = sysTimestamp();
+    mark.cfgReads = G_Z25_PciCfgReads;
+    mark.mmio     = G_Z25_MmioAccesses;
+
+    return mark;
+}/* LocProfStart */
+
+/**********************************************************************/
+/** Routine to account a profiled phase at its exit
+ *
+ *  \param markP        counters at entry, from LocProfStart
+ *  \param phase        IZ25_PROF_xxx
+ *
+ *  \return no return value
+ */
+LOCAL void LocProfStop(Z25_PROF_MARK_TS *markP, u_int32 phase){
+    Z25_PROF_TS *profP = &G_Z25_Prof[phase];
+    u_int32 tick  = (u_int32)tickGet();
+    u_int32 stamp = sysTimestamp();
+
+    profP->calls++;
+    profP->stamps += (u_int64)(tick - markP->tick) * sysTimestampPeriod()
+                     + stamp - markP->stamp;
+    profP->cfgReads += G_Z25_PciCfgReads - markP->cfgReads;
+    profP->mmio     += G_Z25_MmioAccesses - markP->mmio;
+}/* LocProfStop */
+
+/**********************************************************************/
+/** Routine to print the boot time profile
+ *
+ *  This routine prints calls, time, PCI config reads and UART register
+ *  accesses of the profiled driver phases. The values of a phase include
+ *  the phases called by it.
+ *
+ *  \return no return value
+ */
+void Z25_ProfileShow(void){
+    u_int32 freq = sysTimestampFreq();
+    u_int32 i;
+
+    printf("%-24s %6s %12s %10s %8s\n",
+           "phase", "calls", "time [us]", "cfg reads", "mmio");
+    for( i=0; i<IZ25_PROF_MAX; i++ ){
+        printf("%-24s %6u %12u %10u %8u\n",
+               G_Z25_ProfName[i],
+               G_Z25_Prof[i].calls,
+               (freq == 0) ? 0 :
+                   (u_int32)((G_Z25_Prof[i].stamps * 1000000) / freq),
+               G_Z25_Prof[i].cfgReads,
+               G_Z25_Prof[i].mmio);
+    }
+}/* Z25_ProfileShow */
+
+/**********************************************************************/
+/** Routine to clear the boot time profile
+ *
+ *  \return no return value
+ */
+void Z25_ProfileClear(void){
+    OSS_MemFill(NULL, sizeof(G_Z25_Prof), (char *)G_Z25_Prof, 0);
+}/* Z25_ProfileClear */
+#endif /* Z25_PROFILE */
+
 #ifdef DBG
 /**********************************************************************/
 /** Routine to set the debug level
@@ -79,6 +79,28 @@ extern "C" {
                                                       (typically: Z125 uart core) */
 #define IZ25_MAX_UARTS_PER_DEV    		 (4)     /**< maximal number of uarts per device
                                                       (typically: Z25 uart core) */
+#define IZ25_FRAMER_MAX_FRAME    		 (256)   /**< default largest Rx frame */
+#define IZ25_FRAMER_MAX_FRAMES   		 (8)     /**< default Rx frame queue depth */
+#define IZ25_RTU_GAP_BITS        		 (39)    /**< Modbus RTU inter-frame gap,
+                                                      3.5 chars of 11 bits */
+#define IZ25_RTU_MIN_FRAME       		 (4)     /**< Modbus RTU address, function
+                                                      code and CRC */
+#define IZ25_TX_DESC_MAX         		 (16)    /**< queued MEN_UART_TX_DESC
+                                                      per channel */
+#define IZ25_URGENT_SIZE         		 (256)   /**< high priority Tx queue
+                                                      size in bytes */
+#define IZ25_TIMED_TX_SLACK      		 (1)     /**< scheduled message: seconds
+                                                      to wait beyond its load time */
+#define IZ25_SIO_BLOCK_SIZE    		 (128)   /**< SIO block callback buffer,
+                                                      largest FIFO (Z125) */
+#define IZ25_BOND_CHUNK          		 (128)   /**< largest payload of a bond
+                                                      chunk */
+#define IZ25_BOND_FRAME          		 (IZ25_BOND_CHUNK+6) /**< sync, sequence
+                                                      number, length, payload
+                                                      and CRC16 */
+#define IZ25_BOND_SYNC           		 (0xB5)  /**< first byte of a chunk */
+#define IZ25_BOND_DEPTH          		 (4)     /**< reorder window per member
+                                                      in chunks */
 
 #define IZ25_DEVICE_ID_1           (0x4D45)      /**< general FPGA device id */
 #define IZ25_DEVICE_ID_2           (0x0002)      /**< device id: 15EM05_F501 */
@@ -101,15 +123,25 @@ extern "C" {
 #define IZ25_MODID_2               (CHAMELEON_16Z125_UART)      /**< z125 module code */
 #define IZ25_MODID_3               (CHAMELEON_16Z057_UART)      /**< z57 module code */
 #define IZ25_MODID_END             (0xffff)      /**< last supported modcode */
+#define IZ25_NO_MODID              (3)           /**< number of supported
+                                                      modcodes */
+#define IZ25_CHAM_IDX_STEP         (16)          /**< growth of the Chameleon
+                                                      index while parsing */
+#define IZ25_PCI_NO_BAR            (6)           /**< BARs of a PCI header */
 
-#define IZ25_MAX_UNITS              (12)          /**< max. 16z025/16z125 units */
+#define IZ25_UNIT_TABLE_STEP        (4)           /**< growth of the unit tables
+                                                   if the pre-count was short */
+#define IZ25_UNIT_TABLE_SPARE       (4)           /**< spare units allocated by
+                                                   Z25_InitDriver for devices
+                                                   found by Z25_RescanPci */
 #define IZ25_PATH_LENGTH            (16)          /**< max. path length */
+#define IZ25_MAX_PCI_SCAN           (32)          /**< max. Chameleon PCI
+                                                       functions per scan */
 #define IZ25_CHANNEL_OFFSET         (0x10)        /* channel address offset */
 #define IZ25_MAX_DEV_NAME           (20)          /* device name length,
                                                    e.g tyZ25_0 */
 #define IZ25_DOS_COMPATIBILITY      (1843200)     /* dos compatibility mode
 												   frequency */
-#define IZ25_MAX_PCI_DEV			(10)          /* maximal length of pci path */
 
 /* input and output signals */
 
@@ -127,10 +159,32 @@ typedef struct {/* Z25_PCI_SCAN_TS */
     u_int8 busNo;       /**< PCI bus number */
     u_int8 deviceNo;    /**< PCI device number */
     u_int8 funcNo;      /**< PCI function number */
-    u_int32 *nextP;     /**< address of next PCI device */
 } Z25_PCI_SCAN_TS;
 
 
+/** This structure maps a PCI bus to the PCI-to-PCI bridge in front of it.
+ *  An array indexed by bus number is built by LocScanPciDevices.
+ */
+typedef struct {/* Z25_PCI_BRIDGE_TS */
+    u_int8 scanned;     /**< bus has been walked */
+    u_int8 valid;       /**< bus is the secondary bus of a bridge */
+    u_int8 parentBus;   /**< bus number the bridge is located on */
+    u_int8 deviceNo;    /**< PCI device number of the bridge */
+} Z25_PCI_BRIDGE_TS;
+
+/** This structure holds the discovery state of one PCI domain.
+ *  The domains are scanned independently, in own tasks if possible.
+ */
+typedef struct {/* Z25_DOMAIN_SCAN_TS */
+    u_int8  domain;                 /**< PCI domain number */
+    STATUS  status;                 /**< result of LocScanPciDevices */
+    SEM_ID  doneSem;                /**< given when scan task is done */
+    u_int16 noPciDevices;           /**< number of found PCI devices */
+    Z25_PCI_SCAN_TS *pciDevicesP;   /**< found PCI devices */
+    Z25_PCI_BRIDGE_TS *bridgeMapP;  /**< bridge map of the domain */
+    u_int32 cfgReads;               /**< PCI config reads of the scan */
+} Z25_DOMAIN_SCAN_TS;
+
 /** This structure describes the vxworks sio interface.
  */
 typedef struct { /* Z25_SIO_DEVS_TS */
@@ -141,6 +195,12 @@ typedef struct { /* Z25_SIO_DEVS_TS */
 	STATUS	(*putRcvChar)();            /**< pointer to a recvr function */
 	void *	getTxArg;                   /**< pointer to transmitt character */
     void *	putRcvArg;                  /**< pointer to received character */
+	STATUS	(*putRcvBlock)(void *, u_int8 *, int); /**< Rx block callback */
+	int		(*getTxBlock)(void *, u_int8 *, int);  /**< Tx block callback */
+	void *	putRcvBlockArg;             /**< Rx block callback argument */
+	void *	getTxBlockArg;              /**< Tx block callback argument */
+	int		mode;                       /**< SIO_MODE_INT or SIO_MODE_POLL */
+	u_int8	intMask;                    /**< IER saved at SIO_MODE_POLL */
 } Z25_SIO_DEV_TS;
 
 /** This union contains the vxworks sio and ty interface.
@@ -150,11 +210,98 @@ typedef union {/* Z25_TTY_UNION */
 	TY_DEV			    tyDev;
 } Z25_TTY_UNION;
 
+/** This structure holds the Rx framer state of a channel.
+ *
+ *  The framer runs in the receive interrupt on the burst data and sends
+ *  complete frames to msgQId, LocRead returns one frame per call.
+ */
+typedef struct { /* Z25_FRAMER_TS */
+	MEN_UART_FRAMER cfg;    /**< framer configuration */
+	MSG_Q_ID    msgQId;     /**< complete frames for the reader */
+	u_int8      *bufP;      /**< frame under assembly (cfg.maxFrame bytes) */
+	u_int32     pos;        /**< bytes in bufP */
+	u_int32     frameLen;   /**< LENGTH: frame size, 0=header incomplete */
+	u_int8      cobsCode;   /**< COBS: code byte of current block, 0=none */
+	u_int8      cobsLeft;   /**< COBS: data bytes left in current block */
+	BOOL        skip;       /**< discard up to the next frame boundary */
+	u_int16     crc;        /**< MODBUS_RTU: CRC16 of the received bytes */
+	WDOG_ID     rxWd;       /**< MODBUS_RTU: end of frame without FIFO
+	                             char timeout */
+	WDOG_ID     txWd;       /**< MODBUS_RTU: delays Tx start to the end of
+	                             the inter-frame gap */
+	u_int32     idleTick;   /**< MODBUS_RTU: tick the bus is idle again */
+	u_int32     readers;    /**< tasks in LocRead using the framer */
+	BOOL        detached;   /**< replaced by LocFramerSet, freed by the
+	                             last reader */
+} Z25_FRAMER_TS;
+
+/** This structure holds a running write-then-read transaction.
+ *
+ *  It lives on the stack of the task in LocTransaction, the receive
+ *  interrupt fills the response while chanP->transP points to it.
+ */
+typedef struct { /* Z25_TRANS_TS */
+	MEN_UART_TRANSACTION *reqP; /**< request of the caller */
+	u_int32     pos;        /**< response bytes received */
+	u_int32     interTicks; /**< inter-char timeout in ticks, 0=not used */
+	BOOL        done;       /**< response complete */
+} Z25_TRANS_TS;
+
+/** This structure heads the shared copy of a broadcast write.
+ *
+ *  A single allocation holds the header, one descriptor per selected
+ *  channel and the data. The channel draining the last descriptor frees
+ *  it, see Z25_BroadcastWrite.
+ */
+typedef struct { /* Z25_BCAST_TS */
+	u_int32     refCnt;     /**< channels still transmitting the data */
+	MEN_UART_TX_DESC desc[1]; /**< descriptor of each channel, the
+	                             others and the data follow */
+} Z25_BCAST_TS;
+
+/** This structure holds the queue of caller owned Tx buffers.
+ *
+ *  The task side fills slots at tail, the transmit interrupt drains the
+ *  descriptor at head and gives freeSem for each drained slot.
+ */
+typedef struct { /* Z25_TX_DESC_Q_TS */
+	MEN_UART_TX_DESC *descP[IZ25_TX_DESC_MAX]; /**< queued descriptors */
+	Z25_BCAST_TS *bcastP[IZ25_TX_DESC_MAX]; /**< shared copy of a broadcast
+	                             slot, NULL=caller owned buffer */
+	u_int32     head;       /**< next descriptor to transmit */
+	u_int32     tail;       /**< next free slot */
+	u_int32     offset;     /**< bytes of descP[head] already in the FIFO */
+	SEM_ID      freeSem;    /**< counts free slots */
+} Z25_TX_DESC_Q_TS;
+
+/** This structure holds the time scheduled transmission of a channel.
+ */
+typedef struct { /* Z25_TIMED_TX_TS */
+	MEN_UART_TIMED_TX *reqP;    /**< message of the waiting caller */
+	u_int32     offset;     /**< bytes of the message in the FIFO */
+	BOOL        active;     /**< transmit time reached, THRE path sends */
+	SEM_ID      doneSem;    /**< message loaded into the FIFO */
+} Z25_TIMED_TX_TS;
+
+typedef struct Z25_BOND_TS Z25_BOND_TS;
+
 /** This structure describes a single channel of a 16Z025 unit.
+ *
+ *  The structure holds the configuration and tyLib/sio state of a channel
+ *  (cold data). The interrupt dispatch only uses the per unit descriptor
+ *  Z25_ISR_UNIT_TS and touches the channel structure only if data has
+ *  to be moved. The union must stay the first element, the channel is
+ *  passed as SIO_CHAN and DEV_HDR pointer.
  */
 typedef struct { /* Z25_TY_CO_DEV_TS */
 	Z25_TTY_UNION 	u;      /**< vxworks sio and ty interface */
     BOOL 		created;	/**< true if this device has really been created */
+    BOOL 		hwInit;		/**< registers programmed and interrupt enabled,
+                                 done at the first open for tty channels */
+    SEM_ID      chanSem;    /**< channel mutex, serializes the bring up
+                                 and the ioctl resource allocations */
+    Z25_HDL     *devHdlP;   /**< Z25 handle the channel belongs to */
+    u_int16     unitIdx;    /**< index of the unit in quadUart */
 					        /**< Registers are Memory mapped */
     u_int32		addr;		/**< uart channel address */
     u_int32		baseAddr;   /**< uart base address */
@@ -162,19 +309,122 @@ typedef struct { /* Z25_TY_CO_DEV_TS */
 	u_int16     irq;        /**< Interrupt Request Level */
     u_int16     irqvec;     /**< Interrupt Request vector */
 
-	u_int8		channel;	/**< channel number on UART */
-	u_int8 		unit;		/**< UART number in system */
+	u_int16		channel;	/**< channel number on UART */
+	u_int16		unit;		/**< UART number in system */
     u_int32		useCnt;     /**< usage count to track multiple open calls*/
 
 	u_int16     uartCore;   /**< z25/z125 uart core flag described by
                                  IZ25_MODCODE_x defines */
 
-	HDL_16Z25   *unitHdlP;  /**< handle of 16Z25 low level driver (TS_16Z25_UNIT) */
+	TS_16Z25_UNIT uartUnit; /**< 16Z25 low level driver state, embedded to
+                                 save the handle dereference in the ISR */
+	HDL_16Z25   *unitHdlP;  /**< handle of 16Z25 low level driver, points
+                                 to uartUnit (NULL if channel not present) */
 	DBG_HANDLE  *dbgHdlP;   /**< debug handle */
 	u_int16     options;    /**< hardware options */
 
+	u_int32     rxBuffSize; /**< tyLib Rx buffer size */
+	u_int32     txBuffSize; /**< tyLib Tx buffer size */
+	BOOL        rxBuffAuto; /**< Rx buffer size follows the baudrate */
+	BOOL        txBuffAuto; /**< Tx buffer size follows the baudrate */
+
+	u_int32     pollTicks;  /**< poll period in ticks, 0=interrupt mode */
+	WDOG_ID     pollWd;     /**< poll mode watchdog */
+	u_int8      flowCtrl;   /**< flow control, MEN_UART_FLOW_x */
+	BOOL        rxStampOn;  /**< timestamp received data */
+	BOOL        statsOn;    /**< count the traffic */
+	MEN_UART_RX_TIMESTAMP rxStamp;  /**< time of last received data */
+	MEN_UART_STATS stats;   /**< traffic counters */
+	Z25_FRAMER_TS *framerP; /**< Rx framer, NULL=byte stream via tyLib */
+	Z25_TRANS_TS *transP;   /**< running transaction, NULL=none */
+	SEM_ID      transSem;   /**< transaction complete */
+	WDOG_ID     transWd;    /**< transaction inter-char timeout */
+	Z25_TX_DESC_Q_TS *txDescQP; /**< caller owned Tx buffers, NULL until
+	                             the first MEN_UART_IOCTL_WRITEV */
+	RING_ID     urgentRing; /**< high priority Tx queue, drained first at
+	                             every FIFO refill, NULL until the first
+	                             MEN_UART_IOCTL_WRITE_URGENT */
+	Z25_TIMED_TX_TS *timedP; /**< time scheduled transmission, NULL until
+	                             the first MEN_UART_IOCTL_WRITE_AT */
+	Z25_BOND_TS *bondP;     /**< bonded device the channel belongs to,
+	                             NULL=not bonded */
+	u_int8      bondIdx;    /**< member index in the bonded device */
+
 } Z25_TY_CO_DEV_TS;
 
+/** This structure holds the Rx state of a bond member channel.
+ */
+typedef struct { /* Z25_BOND_MEMBER_TS */
+	Z25_TY_CO_DEV_TS *chanP; /**< member channel */
+	u_int8      rxBuf[IZ25_BOND_FRAME]; /**< chunk under assembly */
+	u_int16     pos;        /**< bytes in rxBuf */
+	u_int16     frameLen;   /**< chunk size, 0=header incomplete */
+	u_int16     lastSeq;    /**< sequence number of the last chunk */
+	BOOL        lastValid;  /**< lastSeq valid */
+} Z25_BOND_MEMBER_TS;
+
+/** This structure holds a received chunk waiting for its predecessors.
+ */
+typedef struct { /* Z25_BOND_SLOT_TS */
+	BOOL        valid;      /**< chunk received */
+	u_int16     len;        /**< payload length */
+	u_int8      data[IZ25_BOND_CHUNK]; /**< payload */
+} Z25_BOND_SLOT_TS;
+
+/** This structure describes a bonded device, see Z25_BondCreate.
+ *
+ *  Chunk n is sent on member n % noMembers. The receive interrupt of
+ *  the members puts the chunks into the reorder window, slot[rxHead]
+ *  holds chunk rxSeq. In order chunks are moved to rxRing.
+ */
+struct Z25_BOND_TS { /* Z25_BOND_TS */
+	DEV_HDR     devHdr;     /**< i/o system device, must be first */
+	u_int32     useCnt;     /**< usage count of open calls */
+	u_int16     noMembers;  /**< number of member channels */
+	Z25_BOND_MEMBER_TS member[IZ25_MAX_UARTS_PER_DEV]; /**< members */
+	SEM_ID      txSem;      /**< serializes the writers */
+	u_int16     txSeq;      /**< sequence number of the next Tx chunk */
+	RING_ID     rxRing;     /**< reassembled data for the reader, put by
+	                             interrupt level only */
+	SEM_ID      rxSem;      /**< data available */
+	SEM_ID      rdSem;      /**< serializes the readers */
+	WDOG_ID     rxWd;       /**< moves chunks stalled by a full rxRing */
+	BOOL        rxStalled;  /**< a chunk waits for space in rxRing */
+	BOOL        rxHeld;     /**< RTS of the members deasserted */
+	u_int16     rxSeq;      /**< next expected sequence number */
+	u_int16     rxHead;     /**< slot of rxSeq */
+	u_int16     window;     /**< used slots, noMembers*IZ25_BOND_DEPTH */
+	Z25_BOND_SLOT_TS slot[IZ25_MAX_UARTS_PER_DEV*IZ25_BOND_DEPTH]; /**<
+	                             reorder window */
+};
+
+/** This structure describes a channel in the per unit ISR descriptor.
+ */
+typedef struct { /* Z25_ISR_CHAN_TS */
+    u_int32             addr;       /**< uart channel address (0=not present) */
+    Z25_TY_CO_DEV_TS    *chanP;     /**< channel structure (cold data) */
+    u_int8              created;    /**< create type of the channel,
+                                         copy of chanP->created */
+} Z25_ISR_CHAN_TS;
+
+/** This structure holds everything the interrupt dispatch of a 16Z025/
+ *  16Z125 unit needs. It is allocated cache line aligned and padded to
+ *  full cache lines (see IZ25_ISR_UNIT_SIZE).
+ */
+typedef struct { /* Z25_ISR_UNIT_TS */
+    u_int32         baseAddr;       /**< unit base address (IDIRQ register) */
+    u_int16         uartCore;       /**< z25/z125 uart core flag */
+    u_int8          noChan;         /**< number of channels of the unit */
+    u_int8          connected;      /**< interrupt connected flag */
+    Z25_ISR_CHAN_TS chan[IZ25_MAX_UARTS_PER_DEV]; /**< channels */
+    SEM_ID          connectSem;     /**< serializes the interrupt connect
+                                         of the channels, not used by ISR */
+} Z25_ISR_UNIT_TS;
+
+#define IZ25_ISR_UNIT_SIZE  ((sizeof(Z25_ISR_UNIT_TS) + _CACHE_ALIGN_SIZE - 1) \
+                             & ~(_CACHE_ALIGN_SIZE - 1)) /**< allocation size
+                                                       of Z25_ISR_UNIT_TS */
+
 /** This structure describes the pci bus information of the device.
  */
 typedef struct {/* TS_CHAM_PCI */
@@ -186,13 +436,33 @@ typedef struct {/* TS_CHAM_PCI */
 	u_int8	path[IZ25_PATH_LENGTH];	/**< the pci path of the unit */
 } TS_CHAM_PCI;
 
+/** This structure describes one UART unit of a Chameleon table.
+ */
+typedef struct {/* Z25_CHAM_UNIT_TS */
+    u_int32 addr;                   /**< unit address */
+    u_int16 interrupt;              /**< Chameleon interrupt number */
+    u_int16 instance;               /**< Chameleon instance number */
+} Z25_CHAM_UNIT_TS;
+
+/** This structure indexes the UART units of one Chameleon table.
+ *  The units are grouped by module id (order of G_modId) and keep the
+ *  table order, so instance n of module id k is unitP[modStart[k]+n].
+ */
+typedef struct {/* Z25_CHAM_IDX_TS */
+    BOOL    parsed;                         /**< table has been parsed */
+    u_int16 noUnits;                        /**< number of units in index */
+    u_int16 modStart[IZ25_NO_MODID + 1];    /**< first unit per module id */
+    Z25_CHAM_UNIT_TS *unitP;                /**< indexed units */
+} Z25_CHAM_IDX_TS;
+
 /** This structure describes the available quad uart units per pci device.
  */
 typedef struct { /* Z25_PATH_TS */
 	TS_CHAM_PCI pci;                /**< pci bus information */
 	BOOL		installed;			/**< flag if already installed */
-	u_int8      start16Z25Unit;     /**< start unit of pci device */
-	u_int8      no16Z25Units;       /**< no of units installed in pci device */
+	u_int16     start16Z25Unit;     /**< start unit of pci device */
+	u_int16     no16Z25Units;       /**< no of units installed in pci device */
+	Z25_CHAM_IDX_TS chamIdx;        /**< UART units of the Chameleon table */
 } Z25_PATH_TS;
 
 /** This structure describes the interrupt specific functions.
@@ -210,26 +480,78 @@ typedef struct {/* Z25_IRQ_TS */
 } Z25_IRQ_TS;
 
 /** This structure describes a 16Z025 quad uart.
+ *
+ *  The path and unit tables are allocated from the discovery results,
+ *  see LocFindChameleonDevices and LocCountUartUnits.
  */
 typedef struct {/* Z25_DEV_TS */
-    Z25_PATH_TS pathInfo[IZ25_MAX_PCI_DEV];    /**< pci path information */
+    Z25_PATH_TS *pathInfo;          /**< pci path information [maxPciPaths] */
 
      Z25_TY_CO_DEV_TS
-        quadUart[IZ25_MAX_UNITS][IZ25_MAX_UARTS_PER_DEV];  /**< quad uarts units */
+        (*quadUart)[IZ25_MAX_UARTS_PER_DEV];  /**< quad uarts units [maxUnits] */
 
-    u_int8  noPciPaths;             /**< number of different pci paths */
-    u_int8  no16Z25Dev;             /**< number of detected Z25/Z125 units */
-    u_int8  noUarts;                /**< number of detected Z25/Z125 uarts */
+    Z25_ISR_UNIT_TS **isrUnitP;     /**< ISR descriptors of units [maxUnits] */
+    int16   *driverNumber;          /**< vxworks driver number [maxUnits] */
+
+    u_int16 maxPciPaths;            /**< size of pathInfo */
+    u_int16 maxUnits;               /**< size of the unit tables */
+
+    u_int16 noPciPaths;             /**< number of different pci paths */
+    u_int16 no16Z25Dev;             /**< number of detected Z25/Z125 units */
+    u_int16 noUarts;                /**< number of detected Z25/Z125 uarts */
 
-    int16 driverNumber[IZ25_MAX_UNITS];       /**< vxworks driver number */
     DBG_HANDLE *dbgHdlP;                     /**< debug handle */
 
     u_int16 irqOffset;              /**< interrupt offset for chameleon
                                           interrupt use */
     u_int8  usePciIrq;              /**< use PCI irq (1=enabled, 0=disabled)*/
     Z25_IRQ_TS irqFct;               /**< interrupt functions */
+
+    const Z25_STATIC_DEV *staticMapP;   /**< static device map or NULL if
+                                             the PCI bus was scanned */
+    u_int16 noStaticDevs;           /**< number of entries in staticMapP */
 } Z25_DEV_TS;
 
+/*-----------------------------+
+ |  boot time profiling         |
+ +-----------------------------*/
+#define IZ25_PROF_INIT_DRIVER       (0)     /**< Z25_InitDriver */
+#define IZ25_PROF_FIND_CHAM         (1)     /**< LocFindChameleonDevices */
+#define IZ25_PROF_SCAN_PCI          (2)     /**< LocScanPciDevices of all
+                                                 domains (incl. waiting) */
+#define IZ25_PROF_DEVICE_PATH       (3)     /**< LocGetDevicePath */
+#define IZ25_PROF_FIND_UNITS        (4)     /**< Z25_FindUartUnits */
+#define IZ25_PROF_BASE_BAUD         (5)     /**< Z25_SetBaseBaud */
+#define IZ25_PROF_INSTALL_TTY       (6)     /**< Z25_InstallTtyInterface */
+#define IZ25_PROF_MAX               (7)     /**< number of phases */
+
+#ifdef Z25_PROFILE
+/** This structure accumulates the costs of one profiled phase.
+ */
+typedef struct {/* Z25_PROF_TS */
+    u_int32 calls;          /**< number of calls */
+    u_int64 stamps;         /**< elapsed time in timestamp counts */
+    u_int32 cfgReads;       /**< PCI config space reads */
+    u_int32 mmio;           /**< UART register accesses */
+} Z25_PROF_TS;
+
+/** This structure holds the counters at the entry of a profiled phase.
+ */
+typedef struct {/* Z25_PROF_MARK_TS */
+    u_int32 tick;           /**< system clock tick */
+    u_int32 stamp;          /**< timestamp within tick */
+    u_int32 cfgReads;       /**< G_Z25_PciCfgReads */
+    u_int32 mmio;           /**< G_Z25_MmioAccesses */
+} Z25_PROF_MARK_TS;
+
+# define IZ25_PROF_DECL             Z25_PROF_MARK_TS profMark = LocProfStart();
+# define IZ25_PROF_RETURN(ph, val)  do{ LocProfStop(&profMark, ph); \
+                                        return (val); }while(0)
+#else
+# define IZ25_PROF_DECL
+# define IZ25_PROF_RETURN(ph, val)  return (val)
+#endif /* Z25_PROFILE */
+
 #ifdef __cplusplus
 }
 #endif
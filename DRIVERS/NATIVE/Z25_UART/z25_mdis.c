@@ -61,6 +61,8 @@
 #include "vxWorks.h"            /* always first, CPU type, family , big/litte endian, etc. */
 #include "sysLib.h"
 #include "tyLib.h"
+#include "wdLib.h"
+#include "msgQLib.h"
 
 /* Standard ANSI libraries */
 #include <stdio.h>
@@ -80,6 +82,7 @@
 #include <MEN/maccess.h>
 #include <MEN/ll_defs.h>
 
+#include <MEN/vxttyioctl.h>
 #include <MEN/mz25_module.h>
 #include <MEN/z25_driver.h>
 #include <MEN/z25_mdis.h>
@@ -118,6 +121,36 @@ LOCAL const u_int16 G_deviceIdent[][2]={
 
 static u_int32 G_MdisLevel = OSS_DBG_DEFAULT;
 
+/*--------------------------------------+
+|   TYPEDEFS                            |
++---------------------------------------*/
+/** This structure holds the descriptor settings of one channel.
+ */
+typedef struct {/* Z25_MDIS_CHAN_CFG */
+    u_int32 fioBaudrate;            /**< channel baudrate */
+    u_int32 rxBuffSize;             /**< Rx buffer size */
+    u_int32 txBuffSize;             /**< Tx buffer size */
+    u_int16 rxFifoLevel;            /**< Rx FIFO trigger level */
+    u_int16 txFifoLevel;            /**< Tx FIFO trigger level */
+    u_int16 physMode;               /**< physical mode (RS232, RS485, ...) */
+    u_int32 pollTicks;              /**< poll period, 0=interrupt mode */
+    u_int32 flowControl;            /**< flow control (MEN_UART_FLOW_x) */
+    u_int32 rxTimestamp;            /**< Rx burst timestamps enabled */
+    u_int32 stats;                  /**< Rx/Tx counters enabled */
+} Z25_MDIS_CHAN_CFG;
+
+/** This structure holds the device descriptor settings of an MDIS
+ *  device. It is filled by one pass over the descriptor.
+ */
+typedef struct {/* Z25_MDIS_CONFIG */
+    u_int16 vendorId;               /**< PCI vendor ID */
+    u_int16 deviceId;               /**< PCI device ID */
+    u_int16 idCheck;                /**< ID check enabled */
+    u_int32 debugLevel;             /**< debug level */
+    u_int16 startUnit;              /**< UART unit in FPGA (DEVICE_SLOT) */
+    Z25_MDIS_CHAN_CFG chan[Z25_MAX_UARTS_PER_DEV];  /**< channels */
+} Z25_MDIS_CONFIG;
+
 /*--------------------------------------*/
 /*    LOCAL PROTOTYPES                  */
 /*--------------------------------------*/
@@ -125,28 +158,11 @@ LOCAL int32 LocMdisPciPath( DESC_SPEC *boardDescP,
                             Z25_HDL *hdlP,
                             char *pciPathP);
 
-LOCAL int32 LocGetComponentInfo(DESC_SPEC *deviceDescP,
-                                Z25_HDL *hdlP,
-                                u_int16 *vendorIdP,
-                                u_int16 *deviceIdP,
-                                u_int32*debugLevelP,
-                                u_int16 *idCheckP);
-
-LOCAL int32 LocGetChannelParameter(DESC_SPEC *deviceDescP,
-                                   Z25_HDL *hdlP,
-                                   u_int8 channel,
-                                   u_int32 *fioBaudrateP,
-                                   u_int16 *rxFifoLevelP,
-                                   u_int16 *txFifoLevelP,
-                                   u_int16 *physModeP,
-                                   u_int16 *rxBuffSizeP,
-                                   u_int16 *txBuffSizeP);
-
-LOCAL int32 LocGetUartStartUnit(DESC_SPEC *deviceDescP,
-                                Z25_HDL *hdlP,
-                                u_int16 *startUnitP);
-
-LOCAL STATUS LocPerformIdCheck(DESC_SPEC *deviceDescP,
+LOCAL int32 LocLoadMdisConfig(DESC_SPEC *deviceDescP,
+                              Z25_HDL *hdlP,
+                              Z25_MDIS_CONFIG *cfgP);
+
+LOCAL STATUS LocPerformIdCheck(const Z25_MDIS_CONFIG *cfgP,
                                Z25_HDL *hdlP);
 
 /**********************************************************************/
@@ -170,6 +186,7 @@ LOCAL int32 LocMdisPciPath( DESC_SPEC *boardDescP,
     u_int32 defaultValue = 0;
     Z25_DEV_TS *z25DevP = NULL;
     DESC_HANDLE *boardHdl = NULL;
+    int32 retVal = Z25_ERROR;
 
     /* check input parameter */
     if( boardDescP == NULL )
@@ -230,49 +247,45 @@ LOCAL int32 LocMdisPciPath( DESC_SPEC *boardDescP,
 
     *(pciPathP+length) = (u_int8)(deviceNo & 0x000000ff);
 
-    return Z25_OK;
+    retVal = Z25_OK;
 
     CLEANUP:
+        /* the handle is released on success too */
         if( boardHdl != NULL )
         {
             DESC_Exit( &boardHdl );
         }
 
-        return Z25_ERROR;
+        return retVal;
 }/*LocMdisPciPath*/
 
 /**********************************************************************/
-/** Routine to read the Z25 component information
+/** Routine to read the device descriptor
  *
- *  This routine reads Z25 component information out of the device
- *  descriptor.
+ *  This routine reads the component information, the UART start unit
+ *  and the parameters of all channels out of the device descriptor. The
+ *  descriptor is parsed once, keys which are not set get their default
+ *  value (see PACKAGE_DESC/13z02560.xml).
  *
  *  \param deviceDescP          device descriptor
  *  \param hdlP                 Z25 handle returned by Z25_Init
- *  \param vendorIdP            vendor ID
- *  \param deviceIdP            device ID
- *  \param debugLevelP          debug level information
- *  \param idCheckP             ID-check status
+ *  \param cfgP                 descriptor settings
  *
  *  \return Z25_OK or Z25_ERROR
  */
-LOCAL int32 LocGetComponentInfo(DESC_SPEC *deviceDescP,
-                                Z25_HDL *hdlP,
-                                u_int16 *vendorIdP,
-                                u_int16 *deviceIdP,
-                                u_int32*debugLevelP,
-                                u_int16 *idCheckP)
+LOCAL int32 LocLoadMdisConfig(DESC_SPEC *deviceDescP,
+                              Z25_HDL *hdlP,
+                              Z25_MDIS_CONFIG *cfgP)
 {
-    Z25_DEV_TS *z25DevP = NULL;   /* Z25 resources */
+    Z25_DEV_TS *z25DevP = NULL;     /* Z25 resources */
     DESC_HANDLE *deviceHdl = NULL;  /* device descriptor handle */
-    u_int32 defaultValue = 0;       /* default descriptor value */
-    u_int32 vendorId = 0;           /* vendor id */
-    u_int32 deviceId = 0;           /* device id */
-    u_int32 debugLevel = 0;         /* debug level */
-    u_int32 idCheck = 0;            /* id check */
+    Z25_MDIS_CHAN_CFG *chanP;       /* channel settings */
+    u_int32 value = 0;              /* descriptor value */
+    u_int8 i;                       /* channel */
+    int32 retVal = Z25_ERROR;
 
     /* check input parameter */
-    if( deviceDescP == NULL )
+    if( (deviceDescP == NULL) || (cfgP == NULL) )
     {
         return Z25_ERROR;
     }
@@ -286,6 +299,8 @@ LOCAL int32 LocGetComponentInfo(DESC_SPEC *deviceDescP,
         z25DevP = hdlP;
     }
 
+    bzero((char *)cfgP, sizeof(*cfgP));
+
     /* get device descriptor handle */
     if( DESC_Init(deviceDescP, NULL, &deviceHdl) )
     {
@@ -294,277 +309,93 @@ LOCAL int32 LocGetComponentInfo(DESC_SPEC *deviceDescP,
         goto CLEANUP;
     }
 
-    /* get vendor id */
-    defaultValue = 0x0000;
-    if( DESC_GetUInt32(deviceHdl,
-                       defaultValue,
-                       &vendorId,
-                       "PCI_VENDOR_ID") )
+    /* component information */
+    if( DESC_GetUInt32(deviceHdl, 0x0000, &value, "PCI_VENDOR_ID") )
     {
         DBGWRT_1((z25DevP->dbgHdlP,
             "Z25 - Warning key PCI_VENDOR_ID is disabled !\n"));
     }
-    else
-    {
-        *vendorIdP = (u_int16)(vendorId & 0x0000ffff);
-    }
+    cfgP->vendorId = (u_int16)(value & 0x0000ffff);
 
-    /* get device ID */
-    defaultValue = 0x0000;
-    if( DESC_GetUInt32(deviceHdl,
-                       defaultValue,
-                       &deviceId,
-                       "PCI_DEVICE_ID") )
+    if( DESC_GetUInt32(deviceHdl, 0x0000, &value, "PCI_DEVICE_ID") )
     {
         DBGWRT_1((z25DevP->dbgHdlP,
             "Z25 - Warning key PCI_DEVICE_ID is disabled !\n"));
     }
-    else
-    {
-        *deviceIdP = (u_int16)(deviceId & 0x0000ffff);
-    }
+    cfgP->deviceId = (u_int16)(value & 0x0000ffff);
 
-    /* get debug level */
-    defaultValue = OSS_DBG_DEFAULT;
-    if( DESC_GetUInt32( deviceHdl,
-                        defaultValue,
-                        &debugLevel,
-                        "DEBUG_LEVEL") )
+    if( DESC_GetUInt32(deviceHdl, OSS_DBG_DEFAULT, &value, "DEBUG_LEVEL") )
     {
-        DBGWRT_ERR((z25DevP->dbgHdlP,
-            "Z25 - Error reading descriptor value DEBUG_LEVEL !\n"));
-        goto CLEANUP;
-    }
-    else
-    {
-        *debugLevelP = debugLevel;
+        DBGWRT_2((z25DevP->dbgHdlP,
+            "Z25 - Default value for DEBUG_LEVEL is used !\n"));
     }
+    cfgP->debugLevel = value;
 
-
-    /* module ID check */
-    defaultValue = 0;
-    if( DESC_GetUInt32( deviceHdl,
-                        defaultValue,
-                        &idCheck,
-                        "ID_CHECK" ) )
+    if( DESC_GetUInt32(deviceHdl, 0, &value, "ID_CHECK") )
     {
         DBGWRT_1((z25DevP->dbgHdlP,
             "Z25 - Warning key ID_CHECK is disabled !\n"));
     }
-    else
-    {
-        *idCheckP = (u_int16)(idCheck & 0x0000ffff);
-    }
-
-    /* everything was ok */
-    return Z25_OK;
-
-    CLEANUP:
-        /* return error - parameter might be disabled */
-        if( deviceHdl != NULL )
-        {
-            DESC_Exit( &deviceHdl );
-        }
-
-        return Z25_ERROR;
-}/*LocGetComponentInfo*/
-
-/**********************************************************************/
-/** Routine to read out the channel parameter
- *
- *  This routine reads the channel parameters from the device descriptor.
- *
- *  \param deviceDescP              device descriptor
- *  \param hdlP                     Z25 handle returned by Z25_Init
- *  \param channel                  channel number
- *  \param fioBaudrateP             channel baudrate
- *  \param rxfifoLevelP             Receiver FIFO trigger level
- *  \param txfifoLevelP             Transmitter FIFO trigger level
- *  \param physModeP                physical mode (RS232, RS485, ...)
- *  \param rxBuffSizeP              Rx buffer size
- *  \param txBuffSizeP              Tx buffer size
- *
- *  \return Z25_OK or Z25_ERROR
- */
-LOCAL int32 LocGetChannelParameter(DESC_SPEC *deviceDescP,
-                                   Z25_HDL *hdlP,
-                                   u_int8 channel,
-                                   u_int32 *fioBaudrateP,
-                                   u_int16 *rxFifoLevelP,
-                                   u_int16 *txFifoLevelP,
-                                   u_int16 *physModeP,
-                                   u_int16 *rxBuffSizeP,
-                                   u_int16 *txBuffSizeP)
-{
-    Z25_DEV_TS *z25DevP = NULL;   /* Z25 resources */
-    DESC_HANDLE *deviceHdl = NULL;  /* device descriptor handle */
-    u_int32 defaultValue = 0;       /* default descriptor value */
-    u_int32 fioBaudrate = 0;        /* channel baudrate */
-    u_int32 fifoLevel = 0;          /* fifo level */
-    u_int32 physMode = 0;           /* physical mode */
-    u_int32 rxBuffSize = 0;         /* rx buffer size */
-    u_int32 txBuffSize = 0;         /* tx buffer size */
-
-    /* check input parameter */
-    if( deviceDescP == NULL )
-    {
-        return Z25_ERROR;
-    }
-
-    if( hdlP == NULL )
-    {
-        return Z25_ERROR;
-    }
-    else
-    {
-        z25DevP = hdlP;
-    }
+    cfgP->idCheck = (u_int16)(value & 0x0000ffff);
 
-    /* get device descriptor handle */
-    if( DESC_Init(deviceDescP, NULL, &deviceHdl) )
+    /* UART unit - mandatory */
+    if( DESC_GetUInt32(deviceHdl, 0, &value, "DEVICE_SLOT") )
     {
         DBGWRT_ERR((z25DevP->dbgHdlP,
-            "*** Z25 - Error initializing device descriptor !\n"));
+            "*** Z25 - Error reading descriptor value DEVICE_SLOT !\n"));
         goto CLEANUP;
     }
+    cfgP->startUnit = (u_int16)(value & 0x0000ffff);
 
-    defaultValue = 0;
-    if( DESC_GetUInt32( deviceHdl,
-                    Z25_MDIS_DEFAULT_BAUD,
-                    &fioBaudrate,
-                    "CHANNEL_%d/FIOBAUDRATE", channel ) )
-    {
-        DBGWRT_2((z25DevP->dbgHdlP,
-            "Z25 - Default value for FIOBAUDRATE is used (channel=%d)!\n",
-            channel));
-    }
-    *fioBaudrateP = fioBaudrate;
-
-    if( DESC_GetUInt32( deviceHdl,
-                    Z25_RX_BUFF_SIZE,
-                    &rxBuffSize,
-                    "CHANNEL_%d/RX_BUFF_SIZE", channel ) )
-    {
-        DBGWRT_2((z25DevP->dbgHdlP,
-            "Z25 - Default value for RX_BUFF_SIZE is used (channel=%d)!\n",
-            channel));
-    }
-    *rxBuffSizeP = (u_int16)(rxBuffSize & 0x0000ffff);
-
-    if( DESC_GetUInt32( deviceHdl,
-                    Z25_TX_BUFF_SIZE,
-                    &txBuffSize,
-                    "CHANNEL_%d/TX_BUFF_SIZE", channel) )
-    {
-        DBGWRT_2((z25DevP->dbgHdlP,
-            "Z25 - Default value for TX_BUFF_SIZE is used (channel=%d)!\n",
-            channel));
-    }
-    *txBuffSizeP = (u_int16)(txBuffSize & 0x0000ffff);
-
-    if( DESC_GetUInt32( deviceHdl,
-                    Z25_RX_FIFO_TRIG_LEVEL,
-                    &fifoLevel,
-                    "CHANNEL_%d/FIFO_LEVEL", channel ) )
+    /* channel 0..3 */
+    for( i=0; i<Z25_MAX_UARTS_PER_DEV; i++ )
     {
-        DBGWRT_2((z25DevP->dbgHdlP,
-            "Z25 - Default value for FIFO_LEVEL is used (channel=%d)!\n",
-            channel));
-    }
-    *rxFifoLevelP = (u_int16)(fifoLevel & 0x0000ffff);
+        chanP = &cfgP->chan[i];
 
-    if( DESC_GetUInt32( deviceHdl,
-                    Z25_TX_FIFO_TRIG_LEVEL,
-                    &fifoLevel,
-                    "CHANNEL_%d/TX_FIFO_LEVEL", channel ) )
-    {
-        DBGWRT_2((z25DevP->dbgHdlP,
-            "Z25 - Default value for FIFO_LEVEL is used (channel=%d)!\n",
-            channel));
-    }
-    *txFifoLevelP = (u_int16)(fifoLevel & 0x0000ffff);
+        DESC_GetUInt32( deviceHdl, Z25_MDIS_DEFAULT_BAUD,
+                        &chanP->fioBaudrate, "CHANNEL_%d/FIOBAUDRATE", i );
 
-     if( DESC_GetUInt32( deviceHdl,
-                    Z25_MDIS_DEFAULT_PHYS_INT,
-                    &physMode,
-                    "CHANNEL_%d/PHYS_INT", channel ) )
-    {
-        DBGWRT_2((z25DevP->dbgHdlP,
-            "Z25 - Default value for PHYS_INT is used (channel=%d)!\n",
-            channel));
-    }
-    *physModeP = (u_int16)(physMode & 0x0000ffff);
+        DESC_GetUInt32( deviceHdl, Z25_BUFF_SIZE_AUTO,
+                        &chanP->rxBuffSize, "CHANNEL_%d/RX_BUFF_SIZE", i );
 
+        DESC_GetUInt32( deviceHdl, Z25_BUFF_SIZE_AUTO,
+                        &chanP->txBuffSize, "CHANNEL_%d/TX_BUFF_SIZE", i );
 
-    /* everything was ok */
-    return Z25_OK;
+        DESC_GetUInt32( deviceHdl, Z25_RX_FIFO_TRIG_LEVEL,
+                        &value, "CHANNEL_%d/FIFO_LEVEL", i );
+        chanP->rxFifoLevel = (u_int16)(value & 0x0000ffff);
 
-    CLEANUP:
-        if( deviceHdl != NULL )
-        {
-            DESC_Exit( &deviceHdl );
-        }
+        DESC_GetUInt32( deviceHdl, Z25_TX_FIFO_TRIG_LEVEL,
+                        &value, "CHANNEL_%d/TX_FIFO_LEVEL", i );
+        chanP->txFifoLevel = (u_int16)(value & 0x0000ffff);
 
-        return Z25_ERROR;
-}/*LocGetChannelParameter*/
+        DESC_GetUInt32( deviceHdl, Z25_MDIS_DEFAULT_PHYS_INT,
+                        &value, "CHANNEL_%d/PHYS_INT", i );
+        chanP->physMode = (u_int16)(value & 0x0000ffff);
 
-/**********************************************************************/
-/** Routine to get the UART start unit
- *
- *  This routine returns the first quad UART unit.
- *
- *  \param deviceDescP              device descriptor
- *  \param hdlP                     Z25 handle returned by Z25_Init
- *  \param startUnitP               first quad UART unit
- *
- *  \return Z25_OK or Z25_ERROR
- */
-LOCAL int32 LocGetUartStartUnit(DESC_SPEC *deviceDescP,
-                            Z25_HDL *hdlP,
-                            u_int16 *startUnitP)
-{
-    Z25_DEV_TS *z25DevP = NULL;   /* Z25 resources */
-    DESC_HANDLE *deviceHdl = NULL;  /* device descriptor handle */
-    u_int32 startUnit = 0;          /* first unit to install */
-    u_int32 defaultValue = 0;       /* default descriptor value */
+        DESC_GetUInt32( deviceHdl, Z25_MDIS_DEFAULT_POLL_MODE,
+                        &chanP->pollTicks, "CHANNEL_%d/POLL_MODE", i );
 
-    if( deviceDescP == NULL )
-    {
-        return Z25_ERROR;
-    }
+        DESC_GetUInt32( deviceHdl, Z25_MDIS_DEFAULT_FLOW_CONTROL,
+                        &chanP->flowControl, "CHANNEL_%d/FLOW_CONTROL", i );
 
-    if( hdlP == NULL )
-    {
-        return Z25_ERROR;
-    }
-    else
-    {
-        z25DevP = hdlP;
-    }
+        DESC_GetUInt32( deviceHdl, Z25_MDIS_DEFAULT_RX_TIMESTAMP,
+                        &chanP->rxTimestamp, "CHANNEL_%d/RX_TIMESTAMP", i );
 
-    /* get device descriptor handle */
-    if( DESC_Init(deviceDescP, NULL, &deviceHdl) )
-    {
-        DBGWRT_ERR((z25DevP->dbgHdlP,
-            "*** Z25 - Error initializing device descriptor !\n"));
-        goto CLEANUP;
-    }
+        DESC_GetUInt32( deviceHdl, Z25_MDIS_DEFAULT_STATS,
+                        &chanP->stats, "CHANNEL_%d/STATS", i );
 
-    defaultValue = 0;
-    if( DESC_GetUInt32( deviceHdl,
-                    defaultValue,
-                    &startUnit,
-                    "DEVICE_SLOT" ) )
-    {
-        DBGWRT_ERR((z25DevP->dbgHdlP,
-            "*** Z25 - Error reading descriptor value DEVICE_SLOT !\n"));
-        goto CLEANUP;
+        DBGWRT_2((z25DevP->dbgHdlP,
+            "Z25 - channel %d: baud=%d fifo=%d/%d phys=%d buff=%d/%d\n",
+            i, chanP->fioBaudrate, chanP->rxFifoLevel, chanP->txFifoLevel,
+            chanP->physMode, chanP->rxBuffSize, chanP->txBuffSize));
+        DBGWRT_2((z25DevP->dbgHdlP,
+            "Z25 - channel %d: poll=%d flow=%d stamp=%d stats=%d\n",
+            i, chanP->pollTicks, chanP->flowControl, chanP->rxTimestamp,
+            chanP->stats));
     }
 
-    *startUnitP = (u_int16)(startUnit & 0x0000ffff);
-
-    /* everything was ok */
-    return Z25_OK;
+    retVal = Z25_OK;
 
     CLEANUP:
         if( deviceHdl != NULL )
@@ -572,32 +403,28 @@ LOCAL int32 LocGetUartStartUnit(DESC_SPEC *deviceDescP,
             DESC_Exit( &deviceHdl );
         }
 
-        return Z25_ERROR;
-}/*LocGetUartStartUnit*/
+        return retVal;
+}/*LocLoadMdisConfig*/
 
 /**********************************************************************/
 /** Routine to check the component ID
  *
  *  This routine checks the vendor and device ID on validity.
  *
- *  \param deviceDescP              device descriptor
+ *  \param cfgP                     descriptor settings
  *  \param hdlP                     Z25 handle returned by Z25_Init
  *
  *  \return Z25_OK or Z25_ERROR
  */
-LOCAL STATUS LocPerformIdCheck(DESC_SPEC *deviceDescP,
+LOCAL STATUS LocPerformIdCheck(const Z25_MDIS_CONFIG *cfgP,
                          Z25_HDL *hdlP)
 {
     Z25_DEV_TS *z25DevP = NULL;
     BOOL status = FALSE;
-    u_int16 vendorId = 0;
-    u_int16 deviceId = 0;
-    u_int32 debugLevel = 0;
-    u_int16 idCheck = 0;
     u_int8 i;
 
     /* check input parameter */
-    if( deviceDescP == NULL )
+    if( cfgP == NULL )
     {
         return Z25_ERROR;
     }
@@ -611,37 +438,25 @@ LOCAL STATUS LocPerformIdCheck(DESC_SPEC *deviceDescP,
         z25DevP = hdlP;
     }
 
-    if( LocGetComponentInfo(deviceDescP,
-                            z25DevP,
-                            &vendorId,
-                            &deviceId,
-                            &debugLevel,
-                            &idCheck) != Z25_OK )
+    /* check if vendor and device id combination is valid */
+    if( cfgP->idCheck == 0 )
     {
-        DBGWRT_ERR((z25DevP->dbgHdlP,
-            "*** Z25 - Error getting descriptor values for id-check !\n"));
+        DBGWRT_1((z25DevP->dbgHdlP,
+        "Z25 - Id-check not activated !\n"));
+        status = TRUE;
     }
-    else
-    {/* check if vendor and device id combination is valid */
-        if( idCheck == 0 )
-        {
-            DBGWRT_1((z25DevP->dbgHdlP,
-            "Z25 - Id-check not activated !\n"));
-            status = TRUE;
-        }
 
-        for( i=0; i<15; i++)
+    for( i=0; i<15; i++)
+    {
+        if( (G_deviceIdent[i][0] == cfgP->vendorId) &&
+            (G_deviceIdent[i][1] == cfgP->deviceId) )
         {
-            if( (G_deviceIdent[i][0] == vendorId) &&
-                (G_deviceIdent[i][1] == deviceId) )
-            {
-                status = TRUE;
-                break;
-            }
+            status = TRUE;
+            break;
         }
     }
 
-    Z25_SetDebugLevel(debugLevel);
+    Z25_SetDebugLevel(cfgP->debugLevel);
 
     /* return true, if ID check was successful */
     if( status == TRUE )
@@ -683,12 +498,8 @@ STATUS Z25_MdisDriver(DESC_SPEC *boardDescP, DESC_SPEC *deviceDescP)
     u_int16 noOfUnits = 0;              /* number of uart units */
     u_int16 startUnit = 0;              /* first unit */
     u_int16 pathIndex = 0;              /* index of pci infos */
-    u_int16 rxBuffSize = 0;             /* rx buffer size */
-    u_int16 txBuffSize = 0;             /* tx buffer size */
-    u_int16 rxFifoLevel = 0;            /* Rx fifo trigger level */
-    u_int16 txFifoLevel = 0;            /* Tx fifo trigger level */
-    u_int16 physMode = 0;               /* physical mode rs232, ... */
-    u_int32 fioBaudrate = 0;            /* channel baudrate */
+    Z25_MDIS_CONFIG cfg;                /* device descriptor settings */
+    Z25_MDIS_CHAN_CFG *chanCfgP;        /* channel settings */
 
     bzero(pciPath, sizeof(pciPath));
     bzero(devName, sizeof(devName));
@@ -727,22 +538,23 @@ STATUS Z25_MdisDriver(DESC_SPEC *boardDescP, DESC_SPEC *deviceDescP)
         goto CLEANUP;
     }
 
-    /* check if device is supported by driver */
-    if( LocPerformIdCheck(deviceDescP,
-                          z25DevP) != Z25_OK )
+    /* parse the device descriptor once, all channels */
+    if( LocLoadMdisConfig(deviceDescP,
+                          z25DevP,
+                          &cfg) != Z25_OK )
     {
         DBGWRT_ERR((z25DevP->dbgHdlP,
-            "*** Z25 - Error performing id-check !\n"));
+            "*** Z25 - Error reading device descriptor values !\n"));
+        goto CLEANUP;
     }
+    startUnit = cfg.startUnit;
 
-    /* get the start unit */
-    if( LocGetUartStartUnit(deviceDescP,
-                        z25DevP,
-                        &startUnit) != Z25_OK )
+    /* check if device is supported by driver */
+    if( LocPerformIdCheck(&cfg,
+                          z25DevP) != Z25_OK )
     {
         DBGWRT_ERR((z25DevP->dbgHdlP,
-            "*** Z25 - Error getting start unit!\n"));
-        goto CLEANUP;
+            "*** Z25 - Error performing id-check !\n"));
     }
 
     /* get MDIS interrupt routines */
@@ -766,26 +578,29 @@ STATUS Z25_MdisDriver(DESC_SPEC *boardDescP, DESC_SPEC *deviceDescP)
         goto CLEANUP;
     }
 
-    if( z25DevP->pathInfo[pathIndex].installed == FALSE )
+    /* units are found once per path, the handle is shared by all devices */
     {
-        u_int16 tmpStartUnit = 0;
+        u_int16 pathStartUnit = 0;
         if( Z25_FindUartUnits( z25DevP,
                                 pathIndex,
-                                &tmpStartUnit,
+                                &pathStartUnit,
                                 &noOfUnits) != Z25_OK )
         {
             DBGWRT_ERR((z25DevP->dbgHdlP,
                 "*** Z25 - Error initializing chameleon units.\n"));
             goto CLEANUP;
         }
-    }
 
-    /* check if unit was found in FPGA */
-    if( startUnit == z25DevP->pathInfo[pathIndex].no16Z25Units )
-    {
-        DBGWRT_ERR((z25DevP->dbgHdlP,
-            "*** Z25 - Unknown uart unit number %d !\n", startUnit));
-        goto CLEANUP;
+        /* check if unit was found in FPGA */
+        if( startUnit >= noOfUnits )
+        {
+            DBGWRT_ERR((z25DevP->dbgHdlP,
+                "*** Z25 - Unknown uart unit number %d !\n", startUnit));
+            goto CLEANUP;
+        }
+
+        /* DEVICE_SLOT counts within the FPGA, make it a driver unit */
+        startUnit += pathStartUnit;
     }
 
     /*------------------------------+
@@ -800,31 +615,18 @@ STATUS Z25_MdisDriver(DESC_SPEC *boardDescP, DESC_SPEC *deviceDescP)
 
     z25DevP->pathInfo[pathIndex].installed = TRUE;
 
-    /* read channel 0..3 initialization values if property enabled */
+    /* apply channel 0..3 initialization values */
     for( i=0; i<Z25_MAX_UARTS_PER_DEV; i++ )
     {
         HDL_16Z25 *unitHdlP;
         unitHdlP = z25DevP->quadUart[startUnit][i].unitHdlP;
+        chanCfgP = &cfg.chan[i];
 
         if( z25DevP->quadUart[startUnit][i].addr == 0 )
         {/* invalid address - continue loop */
             continue;
         }
 
-        if( LocGetChannelParameter(deviceDescP,
-                                   z25DevP,
-                                   i,
-                                   &fioBaudrate,
-                                   &rxFifoLevel,
-                                   &txFifoLevel,
-                                   &physMode,
-                                   &rxBuffSize,
-                                   &txBuffSize) != Z25_OK )
-        {
-            DBGWRT_2((z25DevP->dbgHdlP,
-            "Z25 - No descriptor values for channel %d!\n", i));
-        }
-
 		/* set base baud for this unit, only once, on channel 0 */
 		if( 0 == i )
 	    	Z25_SetBaseBaud((Z25_HDL *)z25DevP, 1843200, startUnit);
@@ -835,8 +637,8 @@ STATUS Z25_MdisDriver(DESC_SPEC *boardDescP, DESC_SPEC *deviceDescP)
         			    (int8 *)devName,
                                     startUnit,
                                     i,
-                                    rxBuffSize,
-                                    txBuffSize) != Z25_OK )
+                                    chanCfgP->rxBuffSize,
+                                    chanCfgP->txBuffSize) != Z25_OK )
         {
             DBGWRT_ERR((z25DevP->dbgHdlP,
                 "*** Z25 - !!! Z25_InstallTtyInterface on channel %d!!!!\n",
@@ -844,17 +646,49 @@ STATUS Z25_MdisDriver(DESC_SPEC *boardDescP, DESC_SPEC *deviceDescP)
         }
 
         /* set MDIS initial parameter */
-        if( fioBaudrate > 0 )
+        if( chanCfgP->fioBaudrate > 0 )
         {
-            MZ25_SetBaudrate(unitHdlP, fioBaudrate);
+            MZ25_SetBaudrate(unitHdlP, chanCfgP->fioBaudrate);
+
+            /* auto sized buffers follow the descriptor baudrate */
+            if( (chanCfgP->rxBuffSize == Z25_BUFF_SIZE_AUTO) ||
+                (chanCfgP->txBuffSize == Z25_BUFF_SIZE_AUTO) )
+            {
+                Z25_SetBuffSize((Z25_HDL *)z25DevP, startUnit, i,
+                                chanCfgP->rxBuffSize, chanCfgP->txBuffSize);
+            }
         }
 
-        MZ25_SetFifoTriggerLevel(unitHdlP, 0, rxFifoLevel);
-        MZ25_SetFifoTriggerLevel(unitHdlP, 1, txFifoLevel);
+        MZ25_SetFifoTriggerLevel(unitHdlP, 0, (u_int8)chanCfgP->rxFifoLevel);
+        MZ25_SetFifoTriggerLevel(unitHdlP, 1, (u_int8)chanCfgP->txFifoLevel);
+
+        if( chanCfgP->physMode > 0 )
+        {
+            MZ25_SetSerialMode(unitHdlP, chanCfgP->physMode);
+        }
 
-        if( physMode > 0 )
+        /* performance settings, defaults are the driver defaults */
+        if( chanCfgP->pollTicks > 0 )
+        {
+            Z25_ChannelIoctl((Z25_HDL *)z25DevP, startUnit, i,
+                             MEN_UART_IOCTL_POLL_MODE,
+                             (void *)chanCfgP->pollTicks);
+        }
+        if( chanCfgP->flowControl != MEN_UART_FLOW_NONE )
+        {
+            Z25_ChannelIoctl((Z25_HDL *)z25DevP, startUnit, i,
+                             MEN_UART_IOCTL_FLOW_CONTROL,
+                             (void *)chanCfgP->flowControl);
+        }
+        if( chanCfgP->rxTimestamp )
+        {
+            Z25_ChannelIoctl((Z25_HDL *)z25DevP, startUnit, i,
+                             MEN_UART_IOCTL_RX_TIMESTAMP, (void *)1);
+        }
+        if( chanCfgP->stats )
         {
-            MZ25_SetSerialMode(unitHdlP, physMode);
+            Z25_ChannelIoctl((Z25_HDL *)z25DevP, startUnit, i,
+                             MEN_UART_IOCTL_STATS, (void *)1);
         }
 
         bzero(devName, sizeof(devName));
@@ -144,8 +144,16 @@ extern "C" {
 /*-----------------------------+
  |  register access            |
  +-----------------------------*/
-#define MZ25_REG_READ(addr, reg)		    MREAD_D8(addr, reg)
-#define MZ25_REG_WRITE(addr, reg, data)		MWRITE_D8(addr, reg, data)
+#ifdef Z25_PROFILE
+extern u_int32 G_Z25_MmioAccesses;
+# define MZ25_REG_READ(addr, reg)		    (G_Z25_MmioAccesses++, \
+                                             MREAD_D8(addr, reg))
+# define MZ25_REG_WRITE(addr, reg, data)	(G_Z25_MmioAccesses++, \
+                                             MWRITE_D8(addr, reg, data))
+#else
+# define MZ25_REG_READ(addr, reg)		    MREAD_D8(addr, reg)
+# define MZ25_REG_WRITE(addr, reg, data)	MWRITE_D8(addr, reg, data)
+#endif
 
 #define MZ25_READ_BYTE(x)         MZ25_REG_READ (x,  MIZ25_RHR_OFFSET)
 #define MZ25_WRITE_BYTE(x, byte)  MZ25_REG_WRITE(x, MIZ25_THR_OFFSET, byte)
@@ -178,6 +186,8 @@ extern void MZ25_ModuleId(void);
 
 extern STATUS MZ25_InitHandle(HDL_16Z25 **hdlP, u_int32 address);
 extern STATUS MZ25_FreeHandle(HDL_16Z25 **hdlP);
+extern STATUS MZ25_InitUnit(HDL_16Z25 *hdlP, u_int32 address);
+extern STATUS MZ25_ExitUnit(HDL_16Z25 *hdlP);
 
 extern u_int8 MZ25_EnableInterrupt(HDL_16Z25 *hdlp, u_int8 value);
 extern u_int8 MZ25_DisableInterrupt(HDL_16Z25 *hdlp, u_int8 value);
@@ -213,6 +223,7 @@ extern STATUS MZ25_ControlModemTxInt(HDL_16Z25 *hdlP);
 
 extern STATUS MZ25_SetModemControl(HDL_16Z25 *hdlP, BOOL onOff);
 extern STATUS MZ25_GetModemControl(HDL_16Z25 *hdlP);
+extern STATUS MZ25_RestoreUnit(HDL_16Z25 *hdlP);
 #ifdef __cplusplus
 }
 #endif
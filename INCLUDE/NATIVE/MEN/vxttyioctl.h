@@ -60,6 +60,8 @@ extern "C" {
 |   INCLUDES                             |
 +--------------------------------------*/
 
+#include "semLib.h"   /* SEM_ID of MEN_UART_TX_DESC */
+
 #if _WRS_VXWORKS_MAJOR == 7
 
 #include <sys/ioctl.h>
@@ -67,6 +69,110 @@ extern "C" {
 #define VX_IOCG_MEN_Z135 'Z'
 
 #endif /* VXW 7 */
+/*--------------------------------------+
+| TYPEDEFS |
++--------------------------------------*/
+/* MEN_UART_IOCTL_FLOW_CONTROL modes */
+#define MEN_UART_FLOW_NONE                0
+#define MEN_UART_FLOW_RTS_CTS             1   /* automatic, Z125 only */
+#define MEN_UART_FLOW_XON_XOFF            2
+#define MEN_UART_FLOW_DTR_DSR             3
+
+/* MEN_UART_IOCTL_GET_RX_TIMESTAMP: time the last received data was read */
+typedef struct {
+    UINT32 tick;        /* tickGet() */
+    UINT32 stamp;       /* sysTimestamp(), 0 without timestamp driver */
+} MEN_UART_RX_TIMESTAMP;
+
+/* MEN_UART_IOCTL_GET_STATS: traffic counters of a channel */
+typedef struct {
+    UINT32 rxBytes;     /* bytes received */
+    UINT32 txBytes;     /* bytes transmitted */
+    UINT32 rxBursts;    /* receive interrupts/polls with data */
+    UINT32 txBursts;    /* transmit FIFO refills */
+    UINT32 rxOverruns;  /* UART Rx FIFO overruns */
+    UINT32 rxDropped;   /* bytes lost, Rx buffer full */
+    UINT32 rxFrames;    /* frames passed by the Rx framer */
+    UINT32 rxFramesBad; /* frames rejected by the Rx framer (oversize,
+                           invalid, frame queue full) */
+} MEN_UART_STATS;
+
+/* MEN_UART_IOCTL_TRANSACTION: write request, collect response */
+typedef struct {
+    const UINT8 *txBufP;    /* request */
+    UINT32 txLen;           /* request length */
+    UINT8  *rxBufP;         /* response buffer */
+    UINT32 rxMax;           /* response buffer size, complete if full */
+    UINT32 rxExpected;      /* complete at this length, 0=not used */
+    INT32  terminator;      /* complete at this byte, -1=not used */
+    UINT32 interCharMs;     /* complete after this silence following the
+                               first response byte, 0=not used */
+    UINT32 timeoutMs;       /* total timeout from the request start,
+                               0=wait forever */
+    UINT32 rxLen;           /* out: response length */
+} MEN_UART_TRANSACTION;
+
+/* MEN_UART_IOCTL_WRITEV: caller owned Tx buffer, the transmit interrupt
+   feeds the FIFO directly from bufP (kernel callers only). FIOFLUSH,
+   FIOWFLUSH and the last close cancel queued buffers: doneSem is given,
+   done stays 0 */
+typedef struct {
+    const UINT8 *bufP;      /* data, must stay valid until doneSem/done */
+    UINT32 len;             /* data length */
+    SEM_ID doneSem;         /* given when the data is in the FIFO or the
+                               buffer is cancelled, NULL=none */
+    volatile UINT32 done;   /* set to 1 when the data is in the FIFO */
+} MEN_UART_TX_DESC;
+
+/* MEN_UART_IOCTL_WRITEV: descriptors to queue, in order */
+typedef struct {
+    MEN_UART_TX_DESC *descP;    /* descriptor array */
+    UINT32 noDesc;              /* number of descriptors */
+    UINT32 noQueued;            /* out: descriptors queued, also on error */
+} MEN_UART_WRITEV;
+
+/* MEN_UART_IOCTL_WRITE_URGENT: message for the high priority Tx queue */
+typedef struct {
+    const UINT8 *bufP;      /* message, copied to the queue */
+    UINT32 len;             /* message length */
+} MEN_UART_URGENT;
+
+/* MEN_UART_IOCTL_WRITE_AT: message sent at an absolute time of the time
+   base set by Z25_SetTimeBase (ENOSYS without), kernel callers only */
+typedef struct {
+    const UINT8 *bufP;      /* message, must stay valid until return */
+    UINT32 len;             /* message length */
+    UINT32 txTime;          /* time to load the FIFO */
+    UINT32 startTime;       /* out: time the first byte was loaded */
+} MEN_UART_TIMED_TX;
+
+/* MEN_UART_IOCTL_FRAMER modes */
+#define MEN_UART_FRAMER_NONE              0   /* byte stream */
+#define MEN_UART_FRAMER_DELIMITER         1   /* frame ends with delimiter */
+#define MEN_UART_FRAMER_LENGTH            2   /* header with length field */
+#define MEN_UART_FRAMER_COBS              3   /* COBS encoded, ends with 0 */
+#define MEN_UART_FRAMER_MODBUS_RTU        4   /* Modbus RTU ADU, 3.5 char gap,
+                                                 CRC16 checked. The gap is
+                                                 detected by the 4 char FIFO
+                                                 timeout or in system clock
+                                                 ticks (at least 2) */
+
+/* MEN_UART_IOCTL_FRAMER: Rx framer configuration, read() returns one frame,
+ * empty frames are dropped. select() and FIOFLUSH/FIORFLUSH work on the
+ * frames, FIONREAD is not supported */
+typedef struct {
+    UINT32 mode;        /* MEN_UART_FRAMER_x */
+    UINT32 maxFrame;    /* largest frame in bytes, 0=default (256) */
+    UINT32 maxFrames;   /* frames queued for the reader, 0=default (8) */
+    UINT8  delimiter;   /* DELIMITER: end of frame byte (not passed) */
+    UINT8  hdrSize;     /* LENGTH: header size in bytes */
+    UINT8  lenOffset;   /* LENGTH: offset of the length field in header */
+    UINT8  lenSize;     /* LENGTH: size of the length field 1/2/4 */
+    UINT8  lenBigEndian;/* LENGTH: length field is big endian */
+    UINT8  reserved[3];
+    INT32  lenAdjust;   /* LENGTH: frame size = length field + lenAdjust */
+} MEN_UART_FRAMER;
+
 /*--------------------------------------+
 | DEFINES |
 +--------------------------------------*/
@@ -104,6 +210,26 @@ extern "C" {
 #define MEN_UART_IOCTL_DTR_DSR                     _IOW(VX_IOCG_MEN_Z135, 24, UINT32)
 #define MEN_UART_IOCTL_HANDSHAKE_OFF               _IOW(VX_IOCG_MEN_Z135, 25, UINT32)
 
+/* software buffers */
+#define MEN_UART_IOCTL_SET_RX_BUFF_SIZE            _IOW(VX_IOCG_MEN_Z135, 26, UINT32)
+#define MEN_UART_IOCTL_SET_TX_BUFF_SIZE            _IOW(VX_IOCG_MEN_Z135, 27, UINT32)
+#define MEN_UART_IOCTL_GET_RX_BUFF_SIZE            _IOR(VX_IOCG_MEN_Z135, 28, UINT32)
+#define MEN_UART_IOCTL_GET_TX_BUFF_SIZE            _IOR(VX_IOCG_MEN_Z135, 29, UINT32)
+
+/* performance options */
+#define MEN_UART_IOCTL_POLL_MODE                   _IOW(VX_IOCG_MEN_Z135, 30, UINT32)
+#define MEN_UART_IOCTL_FLOW_CONTROL                _IOW(VX_IOCG_MEN_Z135, 31, UINT32)
+#define MEN_UART_IOCTL_RX_TIMESTAMP                _IOW(VX_IOCG_MEN_Z135, 32, UINT32)
+#define MEN_UART_IOCTL_GET_RX_TIMESTAMP            _IOR(VX_IOCG_MEN_Z135, 33, MEN_UART_RX_TIMESTAMP)
+#define MEN_UART_IOCTL_STATS                       _IOW(VX_IOCG_MEN_Z135, 34, UINT32)
+#define MEN_UART_IOCTL_GET_STATS                   _IOR(VX_IOCG_MEN_Z135, 35, MEN_UART_STATS)
+#define MEN_UART_IOCTL_CLEAR_STATS                 _IOW(VX_IOCG_MEN_Z135, 36, UINT32)
+#define MEN_UART_IOCTL_FRAMER                      _IOW(VX_IOCG_MEN_Z135, 37, MEN_UART_FRAMER)
+#define MEN_UART_IOCTL_TRANSACTION                 _IOWR(VX_IOCG_MEN_Z135, 38, MEN_UART_TRANSACTION)
+#define MEN_UART_IOCTL_WRITEV                      _IOW(VX_IOCG_MEN_Z135, 39, MEN_UART_WRITEV)
+#define MEN_UART_IOCTL_WRITE_URGENT                _IOW(VX_IOCG_MEN_Z135, 40, MEN_UART_URGENT)
+#define MEN_UART_IOCTL_WRITE_AT                    _IOWR(VX_IOCG_MEN_Z135, 41, MEN_UART_TIMED_TX)
+
 #else /* VXW 7 */
 
 #define MEN_UART_IOCTL_DATABITS           100
@@ -136,6 +262,26 @@ extern "C" {
 #define MEN_UART_IOCTL_DTR_DSR            162
 #define MEN_UART_IOCTL_HANDSHAKE_OFF      163
 
+/* software buffers */
+#define MEN_UART_IOCTL_SET_RX_BUFF_SIZE   170
+#define MEN_UART_IOCTL_SET_TX_BUFF_SIZE   171
+#define MEN_UART_IOCTL_GET_RX_BUFF_SIZE   172
+#define MEN_UART_IOCTL_GET_TX_BUFF_SIZE   173
+
+/* performance options */
+#define MEN_UART_IOCTL_POLL_MODE          180
+#define MEN_UART_IOCTL_FLOW_CONTROL       181
+#define MEN_UART_IOCTL_RX_TIMESTAMP       182
+#define MEN_UART_IOCTL_GET_RX_TIMESTAMP   183
+#define MEN_UART_IOCTL_STATS              184
+#define MEN_UART_IOCTL_GET_STATS          185
+#define MEN_UART_IOCTL_CLEAR_STATS        186
+#define MEN_UART_IOCTL_FRAMER             187
+#define MEN_UART_IOCTL_TRANSACTION        188
+#define MEN_UART_IOCTL_WRITEV             189
+#define MEN_UART_IOCTL_WRITE_URGENT       190
+#define MEN_UART_IOCTL_WRITE_AT           191
+
 #endif /* VXW 7 */
 
 #ifdef __cplusplus
@@ -62,17 +62,21 @@ extern "C" {
 
 #define Z25_RX_BUFF_SIZE               (512)	/**< Rx Buffer Size */
 #define Z25_TX_BUFF_SIZE               (512)	/**< Tx Buffer Size */
+#define Z25_BUFF_SIZE_AUTO             (0)		/**< derive buffer size from
+                                                     baudrate, at least
+                                                     Z25_RX/TX_BUFF_SIZE */
+#define Z25_BUFF_AUTO_MS               (100)	/**< time span [ms] an auto
+                                                     sized buffer holds */
 #define Z25_RX_FIFO_TRIG_LEVEL         (4) 		/**< Rx FIFO Trigger Level */
 #define Z25_TX_FIFO_TRIG_LEVEL         (30)		/**< Tx FIFO Trigger Level */
 
 
 #define Z25_MAX_PCI_DEV				    10
-										  /**< maximum number of supported pci devices with Z25/Z125 units */
-										  /* default: 10 */
+										  /**< obsolete, the path table is sized by the PCI scan */
 
 #define Z25_MAX_UNITS        			12
-										  /**< maximum number of supported units in system */
-										  /* default: 12 */
+										  /**< obsolete, the unit tables are sized by the
+										       number of units found */
 
 #define Z25_MAX_UARTS_PER_DEV           4 /**< maximal number of uarts per device */
 										  /* typically 4 in Z25 Quad UART */
@@ -81,11 +85,51 @@ extern "C" {
 #define Z25_PCI_IRQ_ENABLED             (1)           /**< PCI irq enable */
 #define Z25_PCI_IRQ_DISABLED            (0)           /**< PCI irq enable */
 
+/* block callbacks of the SIO interface, installed by callbackInstall */
+#define Z25_SIO_CALLBACK_PUT_RCV_BLOCK  (0x100)       /**< STATUS (*)(void *arg,
+                                                         u_int8 *bufP, int len),
+                                                         gets a Rx burst */
+#define Z25_SIO_CALLBACK_GET_TX_BLOCK   (0x101)       /**< int (*)(void *arg,
+                                                         u_int8 *bufP, int maxLen),
+                                                         returns number of Tx
+                                                         bytes, 0=finished */
+
+/* channel mask of Z25_BroadcastWrite, bit (unit*Z25_MAX_UARTS_PER_DEV+channel) */
+#define Z25_BCAST_MASK_WORDS(noUnits) \
+    ((((noUnits)*Z25_MAX_UARTS_PER_DEV)+31)/32)  /**< mask size in u_int32 */
+#define Z25_BCAST_MASK_SET(maskP,unit,channel) \
+    ((maskP)[((unit)*Z25_MAX_UARTS_PER_DEV+(channel))/32] |= \
+     (1UL << (((unit)*Z25_MAX_UARTS_PER_DEV+(channel))%32)))
+
 /*--------------------------------------+
 |   TYPEDEFS                            |
 +---------------------------------------*/
 typedef void Z25_HDL;
 
+/** UART unit of a static device map entry
+ */
+typedef struct {/* Z25_STATIC_UNIT */
+    u_int16 modCode;    /**< Chameleon module code, e.g.
+                             CHAMELEON_16Z025_UART */
+    u_int16 bar;        /**< PCI BAR the unit resides in */
+    u_int32 offset;     /**< unit offset within the BAR */
+    u_int16 interrupt;  /**< Chameleon interrupt number */
+} Z25_STATIC_UNIT;
+
+/** Chameleon FPGA of a static device map
+ *
+ *  If unitP is NULL, the UART units are read from the Chameleon table
+ *  of the FPGA. Otherwise the table is not read at all.
+ */
+typedef struct {/* Z25_STATIC_DEV */
+    u_int16 domain;                 /**< PCI domain */
+    u_int16 bus;                    /**< PCI bus */
+    u_int16 dev;                    /**< PCI device */
+    u_int16 fct;                    /**< PCI function */
+    const Z25_STATIC_UNIT *unitP;   /**< UART units or NULL */
+    u_int16 noUnits;                /**< number of entries in unitP */
+} Z25_STATIC_DEV;
+
 /*
  * This enumeration contains the Z25 return values.
  */
@@ -101,6 +145,11 @@ extern void Z25_DriverId(void);
 
 extern Z25_HDL * Z25_InitDriver(void);
 
+extern Z25_HDL * Z25_InitDriverStatic(const Z25_STATIC_DEV *mapP,
+                                      u_int16 noDevs);
+
+extern STATUS Z25_VerifyStaticMap(void);
+
 extern Z25_HDL * Z25_CreateDevice(int8 *devName,
 									int8 *inString,
 									u_int8  usePciIrq,
@@ -110,6 +159,10 @@ extern Z25_HDL * Z25_CreateDevice(int8 *devName,
 							        FUNCPTR intConnectAddr,
 							        FUNCPTR intEnableAddr);
 
+extern STATUS Z25_SetTimeBase(FUNCPTR timeGetAddr,
+                              FUNCPTR timeAlarmAddr,
+                              u_int32 freq);
+
 extern STATUS Z25_SetIntFunctions(Z25_HDL *hdlP,
                                  u_int32 irqBase,
 							     FUNCPTR intConnectAddr,
@@ -132,8 +185,33 @@ extern STATUS Z25_InstallTtyInterface(Z25_HDL * hdlP,
 					    			   int8 *devNameP,
 								       u_int16 unit,
 								       u_int16 noOfChan,
-								       u_int16 rxBuffSize,
-								       u_int16 txBuffSize);
+								       u_int32 rxBuffSize,
+								       u_int32 txBuffSize);
+
+extern STATUS Z25_SetBuffSize(Z25_HDL *hdlP,
+							   u_int16 unit,
+							   u_int16 channel,
+							   u_int32 rxBuffSize,
+							   u_int32 txBuffSize);
+
+extern int Z25_ChannelIoctl(Z25_HDL *hdlP,
+							 u_int16 unit,
+							 u_int16 channel,
+							 int request,
+							 void *arg);
+
+extern STATUS Z25_BroadcastWrite(Z25_HDL *hdlP,
+							 const u_int32 *maskP,
+							 u_int16 maskWords,
+							 const u_int8 *bufP,
+							 u_int32 len);
+
+extern STATUS Z25_BondCreate(Z25_HDL *hdlP,
+							 int8 *devNameP,
+							 u_int16 unit,
+							 u_int8 chanMask);
+
+extern STATUS Z25_BondDelete(int8 *devNameP);
 
 extern STATUS Z25_GetPciPathInfo(Z25_HDL *hdlP,
 		    				    int8 *devicePathP,
@@ -144,10 +222,19 @@ extern STATUS Z25_GetIosDriverNumber(Z25_HDL * hdlP,
 
 extern STATUS Z25_FreeHandle(Z25_HDL **hdlP);
 
+extern STATUS Z25_RescanPci(void);
+
+#ifdef Z25_PROFILE
+extern void Z25_ProfileShow(void);
+extern void Z25_ProfileClear(void);
+#endif
+
 extern void Z25_SetDebugLevel(u_int32 level);
 extern u_int32 Z25_GetDebugLevel(void);
 
 extern u_int32 G_Z25_ChamPciDomain;
+extern u_int32 G_Z25_ChamPciDomainMask;
+extern BOOL G_Z25_ParallelDomainScan;
 extern VXB_DEVICE_ID G_Z25_vxbDevID;
 
 
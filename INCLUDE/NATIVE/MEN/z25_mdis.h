@@ -43,6 +43,10 @@ extern "C" {
 /* default MDIS descriptor settings */
 #define Z25_MDIS_DEFAULT_BAUD 			115200
 #define Z25_MDIS_DEFAULT_PHYS_INT	 	     0	/* physical interface (RS232) */
+#define Z25_MDIS_DEFAULT_POLL_MODE	     0	/* interrupt mode */
+#define Z25_MDIS_DEFAULT_FLOW_CONTROL	     0	/* no flow control */
+#define Z25_MDIS_DEFAULT_RX_TIMESTAMP	     0	/* off */
+#define Z25_MDIS_DEFAULT_STATS		     0	/* off */
 
 #include <MEN/dbg.h>
 